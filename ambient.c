@@ -0,0 +1,134 @@
+#include "nrf.h"
+#include "sdk_config.h"
+#include "nrfx_ppi.h"
+#include "app_util.h"
+#include "app_error.h"
+#include "ambient.h"
+
+#if AMBIENT_ENABLED
+
+#define AMBIENT_RTC         NRF_RTC2    /**< RTC опроса (RTC1 занят app_timer) */
+#define AMBIENT_RTC_TICKS   ((AMBIENT_PERIOD_MS * 32768UL + 500) / 1000)    /**< Период в тиках LFCLK */
+
+STATIC_ASSERT(AMBIENT_RTC_TICKS > 1 && AMBIENT_RTC_TICKS <= RTC_CC_COMPARE_Msk, "Ambient sampling period is out of RTC range");
+
+/**
+ * @brief Каналы PPI опроса
+ */
+typedef enum {
+    AMBIENT_PPI_START = 0,  /**< RTC COMPARE0 -> SAADC START, fork RTC CLEAR */
+    AMBIENT_PPI_SAMPLE,     /**< SAADC STARTED -> SAMPLE */
+    AMBIENT_PPI_STOP,       /**< SAADC END -> STOP */
+    AMBIENT_PPI_COUNT
+} ambient_ppi_t;
+
+static volatile int16_t m_sample;                   /**< Результат EasyDMA */
+static nrf_ppi_channel_t m_ppi[AMBIENT_PPI_COUNT];  /**< Каналы PPI опроса */
+
+/**
+ * @brief Ожидание события SAADC со сбросом
+ */
+static void saadc_event_wait(volatile uint32_t * p_event) {
+    while (*p_event == 0) {
+    }
+    *p_event = 0;
+}
+
+ret_code_t ambient_init(uint32_t input) {
+    for (uint32_t i = 0; i < AMBIENT_PPI_COUNT; i++) {
+        ret_code_t err_code = nrfx_ppi_channel_alloc(&m_ppi[i]);
+        if (err_code != NRFX_SUCCESS) {
+            while (i-- > 0) {
+                (void)nrfx_ppi_channel_free(m_ppi[i]);
+            }
+            return err_code;
+        }
+    }
+
+    // SAADC: 12 бит, 4x усреднение в режиме BURST, только по задаче SAMPLE
+    NRF_SAADC->INTENCLR = 0xFFFFFFFF;
+    NRF_SAADC->RESOLUTION = SAADC_RESOLUTION_VAL_12bit;
+    NRF_SAADC->OVERSAMPLE = SAADC_OVERSAMPLE_OVERSAMPLE_Over4x;
+    NRF_SAADC->SAMPLERATE = SAADC_SAMPLERATE_MODE_Task << SAADC_SAMPLERATE_MODE_Pos;
+    NRF_SAADC->CH[0].PSELN = SAADC_CH_PSELN_PSELN_NC;
+    NRF_SAADC->CH[0].CONFIG = (SAADC_CH_CONFIG_RESP_Bypass << SAADC_CH_CONFIG_RESP_Pos)
+                            | (SAADC_CH_CONFIG_RESN_Bypass << SAADC_CH_CONFIG_RESN_Pos)
+                            | (SAADC_CH_CONFIG_GAIN_Gain1_4 << SAADC_CH_CONFIG_GAIN_Pos)
+                            | (SAADC_CH_CONFIG_REFSEL_VDD1_4 << SAADC_CH_CONFIG_REFSEL_Pos)
+                            | (SAADC_CH_CONFIG_TACQ_40us << SAADC_CH_CONFIG_TACQ_Pos)
+                            | (SAADC_CH_CONFIG_MODE_SE << SAADC_CH_CONFIG_MODE_Pos)
+                            | (SAADC_CH_CONFIG_BURST_Enabled << SAADC_CH_CONFIG_BURST_Pos);
+    NRF_SAADC->CH[0].PSELP = input;
+    NRF_SAADC->RESULT.PTR = (uint32_t)&m_sample;
+    NRF_SAADC->RESULT.MAXCNT = 1;
+    NRF_SAADC->ENABLE = SAADC_ENABLE_ENABLE_Enabled;
+
+    // Калибровка смещения; после неё STOP, иначе START может записать лишний отсчёт
+    NRF_SAADC->EVENTS_CALIBRATEDONE = 0;
+    NRF_SAADC->TASKS_CALIBRATEOFFSET = 1;
+    saadc_event_wait(&NRF_SAADC->EVENTS_CALIBRATEDONE);
+    NRF_SAADC->EVENTS_STOPPED = 0;
+    NRF_SAADC->TASKS_STOP = 1;
+    saadc_event_wait(&NRF_SAADC->EVENTS_STOPPED);
+
+    // Первый отсчёт сразу: фильтр не видит нуля до первого периода
+    NRF_SAADC->EVENTS_STARTED = 0;
+    NRF_SAADC->EVENTS_END = 0;
+    NRF_SAADC->EVENTS_STOPPED = 0;
+    NRF_SAADC->TASKS_START = 1;
+    saadc_event_wait(&NRF_SAADC->EVENTS_STARTED);
+    NRF_SAADC->TASKS_SAMPLE = 1;
+    saadc_event_wait(&NRF_SAADC->EVENTS_END);
+    NRF_SAADC->TASKS_STOP = 1;
+    saadc_event_wait(&NRF_SAADC->EVENTS_STOPPED);
+
+    // Период RTC2: COMPARE0 запускает отсчёт и сбрасывает счётчик
+    AMBIENT_RTC->TASKS_STOP = 1;
+    AMBIENT_RTC->TASKS_CLEAR = 1;
+    AMBIENT_RTC->PRESCALER = 0;
+    AMBIENT_RTC->CC[0] = AMBIENT_RTC_TICKS - 1;
+    AMBIENT_RTC->EVTENSET = RTC_EVTEN_COMPARE0_Msk;
+
+    // SAADC в состоянии STARTED только на время отсчёта: START -> SAMPLE -> END -> STOP
+    APP_ERROR_CHECK(nrfx_ppi_channel_assign(m_ppi[AMBIENT_PPI_START],
+                                            (uint32_t)&AMBIENT_RTC->EVENTS_COMPARE[0],
+                                            (uint32_t)&NRF_SAADC->TASKS_START));
+    APP_ERROR_CHECK(nrfx_ppi_channel_fork_assign(m_ppi[AMBIENT_PPI_START], (uint32_t)&AMBIENT_RTC->TASKS_CLEAR));
+    APP_ERROR_CHECK(nrfx_ppi_channel_assign(m_ppi[AMBIENT_PPI_SAMPLE],
+                                            (uint32_t)&NRF_SAADC->EVENTS_STARTED,
+                                            (uint32_t)&NRF_SAADC->TASKS_SAMPLE));
+    APP_ERROR_CHECK(nrfx_ppi_channel_assign(m_ppi[AMBIENT_PPI_STOP],
+                                            (uint32_t)&NRF_SAADC->EVENTS_END,
+                                            (uint32_t)&NRF_SAADC->TASKS_STOP));
+    for (uint32_t i = 0; i < AMBIENT_PPI_COUNT; i++) {
+        APP_ERROR_CHECK(nrfx_ppi_channel_enable(m_ppi[i]));
+    }
+    AMBIENT_RTC->TASKS_START = 1;
+
+    return NRF_SUCCESS;
+}
+
+uint16_t ambient_level_get(void) {
+    // Шум около нуля в несимметричном режиме даёт небольшие отрицательные отсчёты
+    int32_t sample = m_sample;
+
+    return (uint16_t)MIN(MAX(sample, 0), AMBIENT_LEVEL_MAX);
+}
+
+void ambient_uninit(void) {
+    AMBIENT_RTC->TASKS_STOP = 1;
+    AMBIENT_RTC->EVTENCLR = RTC_EVTEN_COMPARE0_Msk;
+
+    for (uint32_t i = 0; i < AMBIENT_PPI_COUNT; i++) {
+        (void)nrfx_ppi_channel_disable(m_ppi[i]);
+        (void)nrfx_ppi_channel_free(m_ppi[i]);
+    }
+
+    // Отсчёт мог начаться до отключения PPI: STOP завершает его
+    NRF_SAADC->EVENTS_STOPPED = 0;
+    NRF_SAADC->TASKS_STOP = 1;
+    saadc_event_wait(&NRF_SAADC->EVENTS_STOPPED);
+    NRF_SAADC->ENABLE = SAADC_ENABLE_ENABLE_Disabled;
+}
+
+#endif // AMBIENT_ENABLED
@@ -0,0 +1,60 @@
+#ifndef AMBIENT_H__
+#define AMBIENT_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+
+#ifndef AMBIENT_ENABLED
+#define AMBIENT_ENABLED     0       /**< Яркость по датчику освещённости */
+#endif
+
+#ifndef AMBIENT_PERIOD_MS
+#define AMBIENT_PERIOD_MS   500     /**< Интервал отсчётов датчика */
+#endif
+
+#define AMBIENT_LEVEL_MAX   4095    /**< Отсчёт при напряжении VDD (12 бит) */
+
+/**
+ * @brief Датчик освещённости на SAADC без участия CPU
+ *
+ * RTC2 по COMPARE0 через PPI запускает START и сбрасывает себя (fork),
+ * STARTED через PPI запускает SAMPLE, SAADC в режиме BURST делает 4
+ * выборки подряд и усредняет их аппаратно, EasyDMA пишет результат,
+ * END через PPI запускает STOP. Между отсчётами SAADC остановлен, как в
+ * режиме low power драйвера nrfx_saadc. Прерываний нет, процессор только
+ * читает результат на своём тике.
+ *
+ * Датчик - делитель от VDD (фототранзистор и резистор, больше света -
+ * выше напряжение); опора VDD/4 с усилением 1/4 делает отсчёт
+ * ратиометрическим, 0..4095 на 0..VDD.
+ *
+ * Стоимость - оценка по PS, на плате не измерена: 4 выборки по 40 + 2 мкс
+ * раз в 500 мс - 0.034% времени, при ~1.2 мА (SAADC с HFINT) в среднем
+ * ~0.4 мкА, RTC2 на уже работающем LFCLK - ещё ~0.1 мкА. Ток SAADC в
+ * состоянии ENABLE между отсчётами в эту оценку не входит; проверяется
+ * замером тока сна с AMBIENT_ENABLED=1 и 0.
+ */
+
+/**
+ * @brief Калибровка смещения, первые отсчёты и запуск периодического опроса
+ *
+ * Вызывается при работающем LFCLK. Блокирует на время калибровки
+ * и первого отсчёта (~1 мс).
+ *
+ * @param input Вход SAADC (PSELP: 1 - AIN0 ... 8 - AIN7, см. BOARD_PIN_AIN)
+ * @return NRF_SUCCESS или ошибка выделения каналов PPI
+ */
+ret_code_t ambient_init(uint32_t input);
+
+/**
+ * @brief Освещённость: последний отсчёт
+ * @return 0..AMBIENT_LEVEL_MAX, больше - светлее
+ */
+uint16_t ambient_level_get(void);
+
+/**
+ * @brief Остановка опроса и отключение SAADC (перед System OFF)
+ */
+void ambient_uninit(void);
+
+#endif // AMBIENT_H__
@@ -0,0 +1,37 @@
+#include "app_util.h"
+#include "ambient_filter.h"
+
+STATIC_ASSERT(AMBIENT_DARK_LEVEL < AMBIENT_BRIGHT_LEVEL && AMBIENT_BRIGHT_LEVEL <= AMBIENT_SAMPLE_MAX,
+              "Ambient light levels must be ordered within the sensor range");
+STATIC_ASSERT(AMBIENT_GAIN_MIN <= AMBIENT_GAIN_MAX, "Ambient gain range is empty");
+
+void ambient_filter_init(ambient_filter_t * p_filter) {
+    p_filter->level = (uint32_t)AMBIENT_BRIGHT_LEVEL << 8;
+}
+
+uint16_t ambient_filter_update(ambient_filter_t * p_filter, uint16_t sample) {
+    if (sample > AMBIENT_SAMPLE_MAX) {
+        sample = AMBIENT_SAMPLE_MAX;
+    }
+
+    // EMA в Q8: шаг меньше 1/256 отсчёта не теряется
+    uint32_t target = (uint32_t)sample << 8;
+    if (target > p_filter->level) {
+        p_filter->level += (target - p_filter->level + (1u << AMBIENT_FILTER_SHIFT) - 1) >> AMBIENT_FILTER_SHIFT;
+    } else {
+        p_filter->level -= (p_filter->level - target + (1u << AMBIENT_FILTER_SHIFT) - 1) >> AMBIENT_FILTER_SHIFT;
+    }
+
+    // Линейно между темнотой и ярким светом
+    if (p_filter->level <= (uint32_t)AMBIENT_DARK_LEVEL << 8) {
+        return AMBIENT_GAIN_MIN;
+    }
+    if (p_filter->level >= (uint32_t)AMBIENT_BRIGHT_LEVEL << 8) {
+        return AMBIENT_GAIN_MAX;
+    }
+
+    uint32_t span = (uint32_t)(AMBIENT_BRIGHT_LEVEL - AMBIENT_DARK_LEVEL) << 8;
+    uint32_t offset = p_filter->level - ((uint32_t)AMBIENT_DARK_LEVEL << 8);
+    return (uint16_t)(AMBIENT_GAIN_MIN
+                      + (uint64_t)offset * (AMBIENT_GAIN_MAX - AMBIENT_GAIN_MIN) / span);
+}
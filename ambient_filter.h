@@ -0,0 +1,55 @@
+#ifndef AMBIENT_FILTER_H__
+#define AMBIENT_FILTER_H__
+
+#include <stdint.h>
+#include "color_model.h"
+
+#ifndef AMBIENT_FILTER_SHIFT
+#define AMBIENT_FILTER_SHIFT    7       /**< Постоянная EMA: 2^7 обновлений (2.6 с при тике 20 мс) */
+#endif
+
+#ifndef AMBIENT_DARK_LEVEL
+#define AMBIENT_DARK_LEVEL      200     /**< Отсчёт датчика (из 4095) в тёмной комнате и ниже */
+#endif
+
+#ifndef AMBIENT_BRIGHT_LEVEL
+#define AMBIENT_BRIGHT_LEVEL    3000    /**< Отсчёт датчика при ярком свете и выше */
+#endif
+
+#ifndef AMBIENT_GAIN_MIN
+#define AMBIENT_GAIN_MIN        6554    /**< Множитель яркости в темноте, Q15 (20%) */
+#endif
+
+#define AMBIENT_GAIN_MAX        COLOR_MODEL_LEVEL_MAX   /**< Множитель при ярком свете (100%) */
+
+#define AMBIENT_SAMPLE_MAX      4095    /**< Максимальный отсчёт датчика (12 бит) */
+
+/**
+ * @brief Сглаживание освещённости и множитель яркости
+ *
+ * Только целые числа; от железа не зависит и собирается на хосте.
+ */
+typedef struct {
+    uint32_t level;     /**< Сглаженный отсчёт, Q8 */
+} ambient_filter_t;
+
+/**
+ * @brief Начальное состояние: яркий свет, множитель 100%
+ *
+ * Первые отсчёты уводят множитель вниз плавно, без скачка при запуске.
+ */
+void ambient_filter_init(ambient_filter_t * p_filter);
+
+/**
+ * @brief Новый отсчёт датчика: шаг EMA и множитель яркости
+ *
+ * Вызывается с постоянным интервалом (тик основного таймера); отсчёт
+ * датчика может обновляться реже - ступеньки сглаживаются фильтром.
+ *
+ * @param p_filter Состояние
+ * @param sample Отсчёт датчика 0..AMBIENT_SAMPLE_MAX (больше - светлее)
+ * @return Множитель яркости AMBIENT_GAIN_MIN..AMBIENT_GAIN_MAX (Q15)
+ */
+uint16_t ambient_filter_update(ambient_filter_t * p_filter, uint16_t sample);
+
+#endif // AMBIENT_FILTER_H__
@@ -0,0 +1,123 @@
+#include "animation.h"
+
+/**
+ * @brief Шаг значения с отражением от границ 0..max
+ */
+static int level_step(int value, int8_t * p_direction, int step, int max) {
+    value += *p_direction * step;
+    if (value >= max) {
+        value = max;
+        *p_direction = -1;
+    } else if (value <= 0) {
+        value = 0;
+        *p_direction = 1;
+    }
+    return value;
+}
+
+/**
+ * @brief Период мигания индикатора в режиме
+ */
+static uint32_t indicator_period_ms(input_mode_t mode, uint32_t current_ms) {
+    switch (mode) {
+        case MODE_NO_INPUT:
+            return 0; // Индикатор выключен
+        case MODE_HUE:
+            return ANIMATION_SLOW_BLINK_MS; // Медленное мигание
+        case MODE_SATURATION:
+            return ANIMATION_FAST_BLINK_MS; // Быстрое мигание
+        case MODE_VALUE:
+            return 1; // Постоянно включен
+        default:
+            return current_ms;
+    }
+}
+
+/**
+ * @brief Параметры мигания индикатора для режима
+ */
+static void indicator_config(animation_t * p_animation, input_mode_t mode, uint32_t full_scale) {
+    p_animation->indicator_period_ms = indicator_period_ms(mode, p_animation->indicator_period_ms);
+
+    // Половина периода на нарастание яркости
+    if (p_animation->indicator_period_ms > 0) {
+        uint64_t half_period_steps = (uint64_t)full_scale * p_animation->step_ms * 2;
+        p_animation->indicator_step = (uint32_t)((half_period_steps + p_animation->indicator_period_ms - 1)
+                                                 / p_animation->indicator_period_ms);
+    } else {
+        p_animation->indicator_step = full_scale;
+    }
+
+    if (p_animation->indicator_step < 1) p_animation->indicator_step = 1;
+}
+
+void animation_init(animation_t * p_animation, uint32_t step_ms) {
+    p_animation->step_ms = step_ms;
+    p_animation->hue_direction = 1;
+    p_animation->saturation_direction = 1;
+    p_animation->value_direction = 1;
+    p_animation->indicator_direction = 1;
+    p_animation->indicator = 0;
+    p_animation->indicator_step = 1;
+    p_animation->indicator_period_ms = 0;
+}
+
+void animation_mode_set(animation_t * p_animation, input_mode_t mode, uint32_t full_scale) {
+    p_animation->hue_direction = 1;
+    p_animation->saturation_direction = 1;
+    p_animation->value_direction = 1;
+
+    indicator_config(p_animation, mode, full_scale);
+}
+
+void animation_step(animation_t * p_animation, app_state_t * p_state, bool hold, uint32_t full_scale) {
+    // Изменение значения текущего режима при удержании кнопки
+    if (hold) {
+        switch (p_state->mode) {
+            case MODE_HUE:
+                p_state->hue += p_animation->hue_direction * ANIMATION_HUE_STEP;
+                if (p_state->hue >= 360.0f) {
+                    p_state->hue = 360.0f;
+                    p_animation->hue_direction = -1;
+                } else if (p_state->hue <= 0.0f) {
+                    p_state->hue = 0.0f;
+                    p_animation->hue_direction = 1;
+                }
+                break;
+
+            case MODE_SATURATION:
+                p_state->saturation = level_step(p_state->saturation, &p_animation->saturation_direction,
+                                                 ANIMATION_LEVEL_STEP, 100);
+                break;
+
+            case MODE_VALUE:
+                p_state->value = level_step(p_state->value, &p_animation->value_direction,
+                                            ANIMATION_LEVEL_STEP, 100);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    // Индикатор
+    if (p_state->mode == MODE_NO_INPUT || p_animation->indicator_period_ms == 0) {
+        p_animation->indicator = 0;
+    } else if (p_state->mode == MODE_VALUE) {
+        p_animation->indicator = full_scale;
+    } else {
+        p_animation->indicator = (uint32_t)level_step((int)p_animation->indicator, &p_animation->indicator_direction,
+                                                      (int)p_animation->indicator_step, (int)full_scale);
+    }
+    p_state->indicator = p_animation->indicator;
+}
+
+bool animation_check(animation_t const * p_animation, app_state_t const * p_state, uint32_t full_scale) {
+    return (uint32_t)p_state->mode < MODE_COUNT
+        && p_state->hue >= 0.0f && p_state->hue <= 360.0f
+        && p_state->saturation >= 0 && p_state->saturation <= 100
+        && p_state->value >= 0 && p_state->value <= 100
+        && p_state->indicator <= full_scale
+        && p_animation->indicator <= full_scale
+        && p_animation->indicator_period_ms == indicator_period_ms(p_state->mode, UINT32_MAX);
+}
@@ -0,0 +1,75 @@
+#ifndef ANIMATION_H__
+#define ANIMATION_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "app_state.h"
+
+#ifndef ANIMATION_HUE_STEP
+#define ANIMATION_HUE_STEP          1       /**< Шаг изменения оттенка за шаг при удержании */
+#endif
+
+#ifndef ANIMATION_LEVEL_STEP
+#define ANIMATION_LEVEL_STEP        1       /**< Шаг изменения насыщенности и яркости за шаг при удержании */
+#endif
+
+#ifndef ANIMATION_SLOW_BLINK_MS
+#define ANIMATION_SLOW_BLINK_MS     1500    /**< Период медленного мигания индикатора */
+#endif
+
+#ifndef ANIMATION_FAST_BLINK_MS
+#define ANIMATION_FAST_BLINK_MS     500     /**< Период быстрого мигания индикатора */
+#endif
+
+/**
+ * @brief Состояние анимации: изменение цвета при удержании и мигание индикатора
+ */
+typedef struct {
+    uint32_t step_ms;               /**< Интервал между шагами */
+    int8_t   hue_direction;         /**< Направление изменения оттенка */
+    int8_t   saturation_direction;  /**< Направление изменения насыщенности */
+    int8_t   value_direction;       /**< Направление изменения яркости */
+    int8_t   indicator_direction;   /**< Направление изменения яркости индикатора */
+    uint32_t indicator;             /**< Текущая яркость индикатора */
+    uint32_t indicator_step;        /**< Шаг изменения индикатора */
+    uint32_t indicator_period_ms;   /**< Период мигания индикатора, 0 - выключен */
+} animation_t;
+
+/**
+ * @brief Начальное состояние
+ * @param p_animation Состояние
+ * @param step_ms Интервал между вызовами animation_step()
+ */
+void animation_init(animation_t * p_animation, uint32_t step_ms);
+
+/**
+ * @brief Смена режима: индикатор под режим, направления изменения сбрасываются
+ * @param p_animation Состояние
+ * @param mode Новый режим
+ * @param full_scale Яркость 100% индикатора
+ */
+void animation_mode_set(animation_t * p_animation, input_mode_t mode, uint32_t full_scale);
+
+/**
+ * @brief Один шаг: изменение цвета в режиме при удержании и яркость индикатора
+ * @param p_animation Состояние
+ * @param p_state Состояние приложения; меняются цвет и indicator
+ * @param hold Кнопка удерживается
+ * @param full_scale Яркость 100% индикатора
+ */
+void animation_step(animation_t * p_animation, app_state_t * p_state, bool hold, uint32_t full_scale);
+
+/**
+ * @brief Проверка инвариантов после animation_step()
+ *
+ * Режим существует, цвет в допустимых пределах, индикатор не ярче 100%,
+ * период мигания соответствует режиму.
+ *
+ * @param p_animation Состояние
+ * @param p_state Состояние приложения
+ * @param full_scale Яркость 100% индикатора
+ * @return true - состояние допустимо
+ */
+bool animation_check(animation_t const * p_animation, app_state_t const * p_state, uint32_t full_scale);
+
+#endif // ANIMATION_H__
@@ -0,0 +1,142 @@
+#include "app_error.h"
+#include "hal.h"
+#include "gesture.h"
+#include "animation.h"
+#include "color_engine.h"
+#include "power_limiter.h"
+#include "app_logic.h"
+
+static app_logic_config_t const * m_p_config;   /**< Параметры */
+
+static gesture_t m_gesture;             /**< Распознавание кликов */
+static animation_t m_animation;         /**< Изменение цвета и мигание индикатора */
+static color_engine_t m_color;          /**< Цвет -> яркости каналов */
+static power_limiter_t m_limiter;       /**< Бюджет тока и снижение при нагреве */
+
+static bool m_sleep_requested = false;  /**< Запрошен переход в System OFF */
+static uint32_t m_idle_time_ms = 0;     /**< Время бездействия с нулевой яркостью */
+static uint16_t m_gain = COLOR_MODEL_LEVEL_MAX; /**< Множитель яркости RGB */
+
+/**
+ * @brief Инварианты распознавания кликов и анимации после события
+ *
+ * Нарушение - ошибка логики: уходит в обработчик ошибок приложения
+ * (на хосте его заменяет прогон, которому нужен останов).
+ */
+static void invariants_check(app_state_t const * p_state, uint32_t now_ms) {
+#if APP_LOGIC_CHECKS
+    if (!gesture_check(&m_gesture, now_ms)
+        || !animation_check(&m_animation, p_state, hal_output_full_scale_get())) {
+        APP_ERROR_HANDLER(NRF_ERROR_INTERNAL);
+    }
+#else
+    (void)p_state;
+    (void)now_ms;
+#endif
+}
+
+void app_logic_init(app_logic_config_t const * p_config, app_state_t const * p_state, uint32_t fade_in_ms) {
+    m_p_config = p_config;
+    m_sleep_requested = false;
+    m_idle_time_ms = 0;
+    m_gain = COLOR_MODEL_LEVEL_MAX;
+
+    gesture_init(&m_gesture);
+    animation_init(&m_animation, p_config->tick_ms);
+    animation_mode_set(&m_animation, p_state->mode, hal_output_full_scale_get());
+    color_engine_init(&m_color, p_config->color_model);
+    if (p_config->p_limiter != NULL) {
+        power_limiter_init(&m_limiter, p_config->p_limiter);
+    }
+    if (fade_in_ms > 0) {
+        color_engine_fade_in(&m_color, p_state, fade_in_ms);
+    }
+
+    app_state_publish(p_state);
+
+    uint32_t rgb[3];
+    color_engine_output(&m_color, p_state, hal_output_full_scale_get(), 0, rgb);
+    hal_output_set(0, rgb);
+}
+
+void app_logic_press(void) {
+    uint32_t now_ms = hal_clock_ms();
+    gesture_event_t event = gesture_press(&m_gesture, now_ms);
+    app_state_t state;
+    app_state_read(&state);
+
+    if (event != GESTURE_NONE) {
+        m_idle_time_ms = 0;
+    }
+
+    if (event == GESTURE_DOUBLE_CLICK) {
+        // Циклическое переключение режимов
+        state.mode = (input_mode_t)((state.mode + 1) % MODE_COUNT);
+        app_state_publish(&state);
+
+        animation_mode_set(&m_animation, state.mode, hal_output_full_scale_get());
+    } else if (event == GESTURE_TRIPLE_CLICK) {
+        // Переход в System OFF после отпускания кнопки
+        m_sleep_requested = true;
+    }
+
+    invariants_check(&state, now_ms);
+}
+
+bool app_logic_tick(app_state_t * p_state) {
+    bool shutdown = false;
+    app_state_t state;
+    app_state_read(&state);
+
+    // Истечение сроков кликов и отпускание кнопки
+    uint32_t now_ms = hal_clock_ms();
+    gesture_poll(&m_gesture, now_ms, hal_input_pressed(m_p_config->button_pin));
+    bool hold = gesture_hold(&m_gesture);
+
+    // Переход в System OFF по бездействию с погашенным светодиодом
+    if (state.value == 0 && !hold) {
+        m_idle_time_ms += m_p_config->tick_ms;
+        if (m_idle_time_ms >= m_p_config->idle_timeout_ms) {
+            m_sleep_requested = true;
+        }
+    } else {
+        m_idle_time_ms = 0;
+    }
+
+    // Выключение только после отпускания, иначе SENSE сразу разбудит
+    if (m_sleep_requested && !hold) {
+        m_sleep_requested = false;
+        shutdown = true;
+    }
+
+    uint32_t full_scale = hal_output_full_scale_get();
+    animation_step(&m_animation, &state, hold, full_scale);
+    invariants_check(&state, now_ms);
+
+    // Новое состояние видно остальным до обновления выходов
+    app_state_publish(&state);
+
+    uint32_t rgb[3];
+    color_engine_output(&m_color, &state, full_scale, m_p_config->tick_ms, rgb);
+    for (int i = 0; i < 3; i++) {
+        rgb[i] = (uint32_t)(((uint64_t)rgb[i] * m_gain + COLOR_MODEL_LEVEL_MAX / 2) / COLOR_MODEL_LEVEL_MAX);
+    }
+    if (m_p_config->p_limiter != NULL) {
+        // Ток - по скважностям, которые действительно уйдут на выходы
+        power_limiter_apply(&m_limiter, full_scale, rgb);
+    }
+    hal_output_set(state.indicator, rgb);
+
+    *p_state = state;
+    return shutdown;
+}
+
+void app_logic_gain_set(uint16_t gain) {
+    m_gain = gain < COLOR_MODEL_LEVEL_MAX ? gain : COLOR_MODEL_LEVEL_MAX;
+}
+
+void app_logic_temperature_set(int32_t temperature) {
+    if (m_p_config->p_limiter != NULL) {
+        power_limiter_temperature_set(&m_limiter, temperature);
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef APP_LOGIC_H__
+#define APP_LOGIC_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "app_state.h"
+#include "color_model.h"
+#include "power_limiter.h"
+
+#ifndef APP_LOGIC_CHECKS
+#define APP_LOGIC_CHECKS    0   /**< Проверка инвариантов автоматов после каждого события (отладка, прогон на хосте) */
+#endif
+
+/**
+ * @brief Параметры логики приложения
+ */
+typedef struct {
+    uint32_t      button_pin;       /**< Кнопка (активный низкий уровень) */
+    color_model_t color_model;      /**< Цветовая модель светодиода */
+    uint32_t      tick_ms;          /**< Интервал app_logic_tick() */
+    uint32_t      idle_timeout_ms;  /**< Бездействие с нулевой яркостью до запроса выключения */
+    power_limiter_config_t const * p_limiter;   /**< Бюджет тока светодиодов, NULL - без ограничения */
+} app_logic_config_t;
+
+/**
+ * @brief Публикует начальное состояние и выводит первый кадр
+ *
+ * Работает только через HAL: выходы должны быть инициализированы
+ * (hal_output_init). Логика собирается и на хосте с HAL_BACKEND_SIM.
+ *
+ * @param p_config Параметры (должны существовать всё время работы)
+ * @param p_state Начальное состояние
+ * @param fade_in_ms Плавное включение с половины яркости (color_engine_fade_in), 0 - сразу
+ */
+void app_logic_init(app_logic_config_t const * p_config, app_state_t const * p_state, uint32_t fade_in_ms);
+
+/**
+ * @brief Нажатие кнопки: распознавание кликов и смена режима
+ *
+ * Вызывается обработчиком входа на том же приоритете, что и app_logic_tick().
+ */
+void app_logic_press(void);
+
+/**
+ * @brief Шаг основного цикла: удержание, анимация, вывод кадра
+ * @param p_state Опубликованное состояние после шага
+ * @return true - запрошено выключение и кнопка отпущена
+ */
+bool app_logic_tick(app_state_t * p_state);
+
+/**
+ * @brief Множитель яркости RGB каналов (освещённость)
+ *
+ * Применяется к каналам после преобразования цвета, начиная со
+ * следующего app_logic_tick(); индикатор не масштабируется.
+ *
+ * @param gain 0..COLOR_MODEL_LEVEL_MAX (100%)
+ */
+void app_logic_gain_set(uint16_t gain);
+
+/**
+ * @brief Температура кристалла для ограничителя тока
+ *
+ * Без ограничителя (p_limiter == NULL) значение не используется.
+ *
+ * @param temperature Температура, 0.25 °C (регистр TEMP)
+ */
+void app_logic_temperature_set(int32_t temperature);
+
+#endif // APP_LOGIC_H__
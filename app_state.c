@@ -0,0 +1,34 @@
+#include "nrf.h"
+#include "app_state.h"
+
+static volatile uint32_t m_sequence;    /**< Чётный - читатели берут копию 0, нечётный - копию 1 */
+static app_state_t m_copies[2];         /**< Две копии состояния */
+
+void app_state_read(app_state_t * p_state) {
+    uint32_t sequence;
+
+    do {
+        sequence = m_sequence;
+        __DMB();
+        *p_state = m_copies[sequence & 1];
+        __DMB();
+    } while (sequence != m_sequence);
+}
+
+void app_state_publish(app_state_t const * p_state) {
+    // Читатели уходят на копию 1, пока меняется копия 0
+    m_sequence++;
+    __DMB();
+    m_copies[0] = *p_state;
+    __DMB();
+
+    // И обратно
+    m_sequence++;
+    __DMB();
+    m_copies[1] = *p_state;
+    __DMB();
+}
+
+uint32_t app_state_sequence(void) {
+    return m_sequence;
+}
@@ -0,0 +1,59 @@
+#ifndef APP_STATE_H__
+#define APP_STATE_H__
+
+#include <stdint.h>
+
+/**
+ * @brief Режимы ввода устройства
+ */
+typedef enum {
+    MODE_NO_INPUT = 0,  /**< Режим без ввода */
+    MODE_HUE,           /**< Режим изменения оттенка */
+    MODE_SATURATION,    /**< Режим изменения насыщенности */
+    MODE_VALUE,         /**< Режим изменения яркости */
+    MODE_COUNT
+} input_mode_t;
+
+/**
+ * @brief Состояние, общее для обработчиков прерываний и основного цикла
+ */
+typedef struct {
+    input_mode_t mode;      /**< Текущий режим ввода */
+    float    hue;           /**< Оттенок (0-360 градусов) */
+    int      saturation;    /**< Насыщенность (0-100%) */
+    int      value;         /**< Яркость (0-100%) */
+    uint32_t indicator;     /**< Яркость индикатора, 0..hal_output_full_scale_get() */
+} app_state_t;
+
+/**
+ * @brief Согласованный снимок состояния
+ *
+ * Состояние хранится в двух копиях с общим счётчиком (seqlock с
+ * защёлкой): пока писатель меняет одну копию, читатели берут другую.
+ * Читатель с более высоким приоритетом, прервавший запись, получает
+ * прежнее состояние с первой попытки; читатель, которого прервала
+ * запись, повторяет чтение. Прерывания не запрещаются.
+ *
+ * Можно вызывать из любого контекста.
+ *
+ * @param p_state Структура для снимка
+ */
+void app_state_read(app_state_t * p_state);
+
+/**
+ * @brief Публикует новое состояние
+ *
+ * Писатели не должны прерывать друг друга: все они работают на одном
+ * приоритете (обработчики GPIOTE и app_timer) или до их запуска.
+ * Изменение одного поля - чтение снимка, правка и публикация.
+ *
+ * @param p_state Новое состояние
+ */
+void app_state_publish(app_state_t const * p_state);
+
+/**
+ * @brief Количество публикаций (удвоенное) - для обнаружения изменений
+ */
+uint32_t app_state_sequence(void);
+
+#endif // APP_STATE_H__
@@ -0,0 +1,116 @@
+#ifndef BOARD_H__
+#define BOARD_H__
+
+#include "nrf_gpio.h"
+#include "sdk_config.h"
+#include "app_util.h"
+#include "led_pwm.h"
+#include "ws2812.h"
+
+/**
+ * @brief Описание платы: пины, каналы светильников, питание
+ *
+ * Плата выбирается define BOARD_<имя> (Makefile: BOARD ?= PCA10059) и
+ * описывается одним файлом board_<имя>.h со списками X-макросов:
+ *   BOARD_PINS(X)           - X(роль, порт, пин) для каждого используемого пина
+ *                             (AMBIENT - аналоговый вход AIN0-AIN7);
+ *   BOARD_RGB_CHANNELS(X)   - X(цвет, роль) для каналов RGB светильника;
+ *   BOARD_DCDC_REG1_PRESENT, BOARD_DCDC_REG0_PRESENT - катушки DC/DC.
+ *
+ * Отсюда при сборке получаются BOARD_PIN_<роль>, пины выходов для HAL
+ * (BOARD_OUTPUT_PINS) и проверки: пин, занятый двумя ролями или
+ * зарезервированный (nRESET, кварц LFXO, NFC), даёт ошибку "redeclaration
+ * of enumerator BOARD_PIN_CLAIMED_P<порт>_<пин>"; несуществующий пин или
+ * неполный набор каналов - ошибку STATIC_ASSERT.
+ *
+ * Все светодиоды - с активным низким уровнем, кнопка замыкает на землю
+ * (подтяжка внутренняя).
+ */
+
+#if defined(BOARD_PCA10059)
+#include "board_pca10059.h"
+#elif defined(BOARD_PCA10056)
+#include "board_pca10056.h"
+#else
+#error "Board is not supported: define BOARD_PCA10059 or BOARD_PCA10056"
+#endif
+
+/* ---------------- Пины ---------------- */
+
+#define BOARD_PIN_ENUM_(role, port, pin)    BOARD_PIN_##role = NRF_GPIO_PIN_MAP(port, pin),
+
+/**
+ * @brief Пины по ролям: BOARD_PIN_INDICATOR, BOARD_PIN_BUTTON, ...
+ */
+enum {
+    BOARD_PINS(BOARD_PIN_ENUM_)
+};
+
+/* Каждый пин объявляется один раз: повтор - ошибка компиляции */
+#define BOARD_PIN_CLAIM_(role, port, pin)   BOARD_PIN_CLAIMED_P##port##_##pin,
+
+enum {
+    BOARD_PINS(BOARD_PIN_CLAIM_)
+#if defined(CONFIG_GPIO_AS_PINRESET)
+    BOARD_PIN_CLAIMED_P0_18,    /**< nRESET */
+#endif
+#if !defined(CONFIG_NFCT_PINS_AS_GPIOS)
+    BOARD_PIN_CLAIMED_P0_9,     /**< NFC1 */
+    BOARD_PIN_CLAIMED_P0_10,    /**< NFC2 */
+#endif
+    BOARD_PIN_CLAIMED_P0_0,     /**< XL1 - кварц LFXO */
+    BOARD_PIN_CLAIMED_P0_1,     /**< XL2 - кварц LFXO */
+};
+
+/* nRF52840: P0.00-P0.31, P1.00-P1.15 */
+#define BOARD_PIN_RANGE_(role, port, pin)                                               \
+    STATIC_ASSERT((port) == 0 ? (pin) < 32 : ((port) == 1 && (pin) < 16),              \
+                  "Pin " #role " does not exist on nRF52840");
+
+BOARD_PINS(BOARD_PIN_RANGE_)
+
+/* Вход SAADC для пина (PSELP: 1 - AIN0 ... 8 - AIN7), 0 - пин не аналоговый.
+   nRF52840: AIN0-AIN3 - P0.02-P0.05, AIN4-AIN7 - P0.28-P0.31 */
+#define BOARD_PIN_AIN(pin)                                                              \
+    ((pin) >= NRF_GPIO_PIN_MAP(0, 2) && (pin) <= NRF_GPIO_PIN_MAP(0, 5) ? (pin) - 1 :   \
+     (pin) >= NRF_GPIO_PIN_MAP(0, 28) && (pin) <= NRF_GPIO_PIN_MAP(0, 31) ? (pin) - 23 : 0)
+
+STATIC_ASSERT(BOARD_PIN_AIN(BOARD_PIN_AMBIENT) != 0, "Ambient light sensor pin is not an analog input");
+
+/* ---------------- Каналы ---------------- */
+
+#define BOARD_COLOR_RED     0   /**< Индекс красного канала в hal_output_pins_t.rgb_pins */
+#define BOARD_COLOR_GREEN   1   /**< Индекс зелёного канала */
+#define BOARD_COLOR_BLUE    2   /**< Индекс синего канала */
+
+/* Каждый цвет - один раз; неизвестный цвет - необъявленный BOARD_COLOR_<цвет> */
+#define BOARD_COLOR_CLAIM_(color, role)     BOARD_COLOR_CLAIMED_##color = BOARD_COLOR_##color,
+
+enum {
+    BOARD_RGB_CHANNELS(BOARD_COLOR_CLAIM_)
+};
+
+#define BOARD_CHANNEL_COUNT_(color, role)   + 1
+
+STATIC_ASSERT((0 BOARD_RGB_CHANNELS(BOARD_CHANNEL_COUNT_)) == 3, "RGB fixture needs red, green and blue channels");
+
+/* Индикатор и RGB светильник: каналов не больше, чем у PWM, не занятых лентой */
+#define BOARD_PWM_CHANNELS_USED     (1 + (0 BOARD_RGB_CHANNELS(BOARD_CHANNEL_COUNT_)))
+#define BOARD_PWM_INSTANCES_FREE    (NRFX_PWM0_ENABLED + NRFX_PWM1_ENABLED + NRFX_PWM2_ENABLED          \
+                                     + (NRFX_PWM3_ENABLED && !(WS2812_ENABLED && WS2812_PWM_INSTANCE == 3)))
+
+STATIC_ASSERT(BOARD_PWM_CHANNELS_USED <= BOARD_PWM_INSTANCES_FREE * LED_PWM_FIXTURE_CHANNELS_MAX,
+              "Board fixtures need more PWM channels than available");
+
+#define BOARD_RGB_PIN_(color, role)         [BOARD_COLOR_##color] = BOARD_PIN_##role,
+
+/**
+ * @brief Пины выходов HAL: индикатор и RGB каналы по цветам
+ */
+#define BOARD_OUTPUT_PINS                                   \
+    {                                                       \
+        .indicator_pin = BOARD_PIN_INDICATOR,               \
+        .rgb_pins = { BOARD_RGB_CHANNELS(BOARD_RGB_PIN_) }  \
+    }
+
+#endif // BOARD_H__
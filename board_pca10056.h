@@ -0,0 +1,35 @@
+#ifndef BOARD_PCA10056_H__
+#define BOARD_PCA10056_H__
+
+/**
+ * @brief nRF52840 DK (PCA10056)
+ *
+ * RGB светодиода на плате нет: LED1 - индикатор, LED2-LED4 - красный,
+ * зелёный и синий каналы. Button 1 - кнопка. Лента и отладочный пин
+ * запуска - на разъёме P1, датчик освещённости - AIN1 на разъёме P3.
+ */
+
+#define BOARD_NAME  "PCA10056"
+
+/* Роли пинов: X(роль, порт, пин); порт и пин - десятичные литералы без ведущих нулей */
+#define BOARD_PINS(X)               \
+    X(INDICATOR,    0, 13)          \
+    X(LED_RED,      0, 14)          \
+    X(LED_GREEN,    0, 15)          \
+    X(LED_BLUE,     0, 16)          \
+    X(BUTTON,       0, 11)          \
+    X(WS2812,       1, 1)           \
+    X(BOOT_TIMING,  1, 2)           \
+    X(AMBIENT,      0, 3)
+
+/* Каналы RGB светильника: X(цвет, роль пина) */
+#define BOARD_RGB_CHANNELS(X)       \
+    X(RED,      LED_RED)            \
+    X(GREEN,    LED_GREEN)          \
+    X(BLUE,     LED_BLUE)
+
+/* Катушка DC/DC только у REG1; от VDDH плата по умолчанию не питается */
+#define BOARD_DCDC_REG1_PRESENT     1
+#define BOARD_DCDC_REG0_PRESENT     0
+
+#endif // BOARD_PCA10056_H__
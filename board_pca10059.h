@@ -0,0 +1,34 @@
+#ifndef BOARD_PCA10059_H__
+#define BOARD_PCA10059_H__
+
+/**
+ * @brief nRF52840 Dongle (PCA10059)
+ *
+ * LED1 - индикатор, LED2 - RGB, SW1 - кнопка. Лента, отладочный пин
+ * запуска и датчик освещённости (AIN0) выведены на контакты края платы.
+ */
+
+#define BOARD_NAME  "PCA10059"
+
+/* Роли пинов: X(роль, порт, пин); порт и пин - десятичные литералы без ведущих нулей */
+#define BOARD_PINS(X)               \
+    X(INDICATOR,    0, 6)           \
+    X(LED_RED,      0, 8)           \
+    X(LED_GREEN,    1, 9)           \
+    X(LED_BLUE,     0, 12)          \
+    X(BUTTON,       1, 6)           \
+    X(WS2812,       0, 13)          \
+    X(BOOT_TIMING,  0, 29)          \
+    X(AMBIENT,      0, 2)
+
+/* Каналы RGB светильника: X(цвет, роль пина) */
+#define BOARD_RGB_CHANNELS(X)       \
+    X(RED,      LED_RED)            \
+    X(GREEN,    LED_GREEN)          \
+    X(BLUE,     LED_BLUE)
+
+/* Катушки DC/DC: REG1 (DCDCEN) и REG0 (DCDCEN0, питание от VDDH через USB) */
+#define BOARD_DCDC_REG1_PRESENT     1
+#define BOARD_DCDC_REG0_PRESENT     1
+
+#endif // BOARD_PCA10059_H__
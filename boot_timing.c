@@ -0,0 +1,29 @@
+#include "nrf.h"
+#include "cycle_counter.h"
+#include "boot_timing.h"
+
+static uint32_t m_start;                        /**< CYCCNT при входе в main() */
+static uint32_t m_cycles[BOOT_TIMING_COUNT];    /**< Такты от входа в main() до завершения этапов */
+
+void boot_timing_start(void) {
+    cycle_counter_init();
+    m_start = cycle_counter_get();
+
+    nrf_gpio_pin_set(BOOT_TIMING_PIN);
+    nrf_gpio_cfg_output(BOOT_TIMING_PIN);
+}
+
+void boot_timing_mark(boot_timing_stage_t stage) {
+    m_cycles[stage] = cycle_counter_get() - m_start;
+
+    if (stage == BOOT_TIMING_FIRST_LIGHT) {
+        nrf_gpio_pin_clear(BOOT_TIMING_PIN);
+    }
+}
+
+void boot_timing_get(boot_timing_t * p_timing) {
+    for (int i = 0; i < BOOT_TIMING_COUNT; i++) {
+        p_timing->cycles[i] = m_cycles[i];
+        p_timing->us[i] = (uint32_t)cycle_counter_to_us(m_cycles[i]);
+    }
+}
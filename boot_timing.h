@@ -0,0 +1,51 @@
+#ifndef BOOT_TIMING_H__
+#define BOOT_TIMING_H__
+
+#include <stdint.h>
+#include "nrf_gpio.h"
+#include "board.h"
+
+#ifndef BOOT_TIMING_PIN
+#define BOOT_TIMING_PIN     BOARD_PIN_BOOT_TIMING   /**< Отладочный пин: 1 от входа в main() до первого фронта PWM */
+#endif
+
+/**
+ * @brief Этапы запуска
+ */
+typedef enum {
+    BOOT_TIMING_CLOCKS = 0,     /**< DC/DC и запуск LFRC */
+    BOOT_TIMING_FIRST_LIGHT,    /**< Запущен PWM с восстановленным цветом */
+    BOOT_TIMING_LFCLK,          /**< LFCLK работает, можно запускать app_timer */
+    BOOT_TIMING_COUNT
+} boot_timing_stage_t;
+
+/**
+ * @brief Время этапов от входа в main()
+ */
+typedef struct {
+    uint32_t cycles[BOOT_TIMING_COUNT]; /**< Такты DWT CYCCNT */
+    uint32_t us[BOOT_TIMING_COUNT];     /**< То же в микросекундах */
+} boot_timing_t;
+
+/**
+ * @brief Запускает отсчёт: включает DWT CYCCNT и выставляет BOOT_TIMING_PIN
+ *
+ * Вызывается первой строкой main(). DWT не видит код до main()
+ * (копирование .data, SystemInit, обнуление .bss) - полное время от
+ * сброса измеряется осциллографом между фронтом nRESET и спадом
+ * BOOT_TIMING_PIN. Этапы отсчитываются от отметки в этой функции, так что
+ * замеры и power_monitor, включающие тот же счётчик, их не портят.
+ */
+void boot_timing_start(void);
+
+/**
+ * @brief Отмечает завершение этапа; после BOOT_TIMING_FIRST_LIGHT пин сбрасывается
+ */
+void boot_timing_mark(boot_timing_stage_t stage);
+
+/**
+ * @brief Результаты замера
+ */
+void boot_timing_get(boot_timing_t * p_timing);
+
+#endif // BOOT_TIMING_H__
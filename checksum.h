@@ -0,0 +1,28 @@
+#ifndef CHECKSUM_H__
+#define CHECKSUM_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Контрольная сумма FNV-1a (32 бита)
+ *
+ * Общая для записей во flash и в RAM, сохраняемой в System OFF:
+ * ловит стёртую или недописанную страницу и случайное содержимое
+ * RAM после подачи питания.
+ *
+ * @param p_data Данные
+ * @param size Размер в байтах
+ */
+static inline uint32_t checksum_fnv1a(void const * p_data, size_t size) {
+    uint8_t const * p_bytes = (uint8_t const *)p_data;
+    uint32_t hash = 2166136261UL;
+
+    for (size_t i = 0; i < size; i++) {
+        hash ^= p_bytes[i];
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+#endif // CHECKSUM_H__
@@ -0,0 +1,144 @@
+#include <string.h>
+#include "nrf.h"
+#include "app_util.h"
+#include "app_util_platform.h"
+#include "nrfx_nvmc.h"
+#include "checksum.h"
+#include "color_calib.h"
+
+#define CALIB_MAGIC         0xC0CA11B0UL    /**< Признак записанной калибровки */
+#define CALIB_COEF_BITS     (COLOR_CALIB_MATRIX_BITS + COLOR_MODEL_LEVEL_BITS)  /**< Коэффициент 1.0 при 100% */
+
+/* Символы из blinky_gcc_nrf52.ld: страница flash, исключённая из FLASH */
+extern uint32_t __color_calib_start[];
+
+/**
+ * @brief Запись калибровки во flash
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t size;
+    uint32_t checksum;
+    color_calib_t calib;
+} calib_record_t;
+
+STATIC_ASSERT(sizeof(calib_record_t) % sizeof(uint32_t) == 0, "Flash record must be whole words");
+
+static color_calib_t m_calib;       /**< Текущая калибровка */
+static int32_t  m_coef[3][3];       /**< Матрица, масштабированная предельными уровнями: 1.0 при 100% = 2^CALIB_COEF_BITS */
+static uint32_t m_limit[3];         /**< Предельные уровни каналов, Q15 */
+
+static inline calib_record_t const * calib_record_flash(void) {
+    return (calib_record_t const *)&__color_calib_start;
+}
+
+/**
+ * @brief Проверка записи во flash
+ */
+static bool calib_record_valid(calib_record_t const * p_record) {
+    return p_record->magic == CALIB_MAGIC
+        && p_record->size == sizeof(color_calib_t)
+        && p_record->checksum == checksum_fnv1a(&p_record->calib, sizeof(color_calib_t));
+}
+
+void color_calib_default_get(color_calib_t * p_calib) {
+    memset(p_calib, 0, sizeof(*p_calib));
+    for (int i = 0; i < 3; i++) {
+        p_calib->matrix[i][i] = COLOR_CALIB_MATRIX_ONE;
+        p_calib->max_level[i] = COLOR_MODEL_LEVEL_MAX;
+    }
+}
+
+void color_calib_get(color_calib_t * p_calib) {
+    *p_calib = m_calib;
+}
+
+ret_code_t color_calib_set(color_calib_t const * p_calib) {
+    int32_t coef[3][3];
+
+    for (int i = 0; i < 3; i++) {
+        if (p_calib->max_level[i] > COLOR_MODEL_LEVEL_MAX) {
+            return NRF_ERROR_INVALID_PARAM;
+        }
+        // Предельный уровень переводится в 2^15 = 100%, чтобы вход Q15 не требовал деления
+        for (int j = 0; j < 3; j++) {
+            coef[i][j] = (int32_t)(((int64_t)p_calib->matrix[i][j] * p_calib->max_level[i]
+                                    * (1 << COLOR_MODEL_LEVEL_BITS) + COLOR_MODEL_LEVEL_MAX / 2)
+                                   / COLOR_MODEL_LEVEL_MAX);
+        }
+    }
+
+    // Таблица читается из обработчика таймера
+    CRITICAL_REGION_ENTER();
+    m_calib = *p_calib;
+    memcpy(m_coef, coef, sizeof(m_coef));
+    for (int i = 0; i < 3; i++) {
+        m_limit[i] = p_calib->max_level[i];
+    }
+    CRITICAL_REGION_EXIT();
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t color_calib_load(void) {
+    calib_record_t const * p_record = calib_record_flash();
+
+    if (!calib_record_valid(p_record)) {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    return color_calib_set(&p_record->calib);
+}
+
+ret_code_t color_calib_save(void) {
+    calib_record_t record = {
+        .magic = CALIB_MAGIC,
+        .size = sizeof(color_calib_t),
+        .calib = m_calib
+    };
+    record.checksum = checksum_fnv1a(&record.calib, sizeof(record.calib));
+
+    calib_record_t const * p_record = calib_record_flash();
+    if (memcmp(p_record, &record, sizeof(record)) == 0) {
+        return NRF_SUCCESS;
+    }
+
+    uint32_t address = (uint32_t)(uintptr_t)&__color_calib_start;
+    nrfx_nvmc_page_erase(address);
+    nrfx_nvmc_words_write(address, &record, sizeof(record) / sizeof(uint32_t));
+    while (!nrfx_nvmc_write_done_check()) {
+    }
+
+    if (memcmp(p_record, &record, sizeof(record)) != 0) {
+        return NRF_ERROR_INTERNAL;
+    }
+    return NRF_SUCCESS;
+}
+
+void color_calib_init(void) {
+    if (color_calib_load() != NRF_SUCCESS) {
+        color_calib_t calib;
+        color_calib_default_get(&calib);
+        color_calib_set(&calib);
+    }
+}
+
+void color_calib_apply(color_channels_t const * p_channels, uint32_t full_scale, uint32_t p_out[3]) {
+    const int32_t in[3] = { p_channels->r, p_channels->g, p_channels->b };
+
+    for (int i = 0; i < 3; i++) {
+        // Q27 * Q15: SMLAL на Cortex-M4
+        int64_t acc = (int64_t)m_coef[i][0] * in[0]
+                    + (int64_t)m_coef[i][1] * in[1]
+                    + (int64_t)m_coef[i][2] * in[2];
+        int32_t level = (int32_t)((acc + (1LL << (CALIB_COEF_BITS - 1))) >> CALIB_COEF_BITS);
+
+        // Выход матрицы ограничен 100%, что после масштабирования - предельный уровень канала
+        if (level < 0) {
+            level = 0;
+        } else if ((uint32_t)level > m_limit[i]) {
+            level = (int32_t)m_limit[i];
+        }
+
+        p_out[i] = (uint32_t)(((uint64_t)level * full_scale + COLOR_MODEL_LEVEL_MAX / 2) / COLOR_MODEL_LEVEL_MAX);
+    }
+}
@@ -0,0 +1,72 @@
+#ifndef COLOR_CALIB_H__
+#define COLOR_CALIB_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+#include "color_model.h"
+
+#define COLOR_CALIB_MATRIX_BITS 12      /**< Разрядность коэффициентов матрицы: Q12 */
+#define COLOR_CALIB_MATRIX_ONE  (1 << COLOR_CALIB_MATRIX_BITS)  /**< Коэффициент 1.0 */
+
+/**
+ * @brief Калибровка RGB светодиода конкретного экземпляра платы
+ *
+ * Строка матрицы - выходной канал (R, G, B), столбец - входной. Выход
+ * матрицы ограничивается 100%, затем масштабируется предельным уровнем
+ * канала.
+ */
+typedef struct {
+    int16_t  matrix[3][3];  /**< Матрица коррекции цвета, Q12 */
+    uint16_t max_level[3];  /**< Предельный уровень канала, Q15 (COLOR_MODEL_LEVEL_MAX - 100%) */
+} color_calib_t;
+
+/**
+ * @brief Загружает калибровку из flash, при её отсутствии - единичную
+ */
+void color_calib_init(void);
+
+/**
+ * @brief Калибровка по умолчанию: единичная матрица, 100% на всех каналах
+ */
+void color_calib_default_get(color_calib_t * p_calib);
+
+/**
+ * @brief Текущая калибровка
+ */
+void color_calib_get(color_calib_t * p_calib);
+
+/**
+ * @brief Применяет калибровку сразу, без записи во flash
+ * @return NRF_SUCCESS или NRF_ERROR_INVALID_PARAM (уровень больше 100%)
+ */
+ret_code_t color_calib_set(color_calib_t const * p_calib);
+
+/**
+ * @brief Перечитывает калибровку из flash
+ * @return NRF_SUCCESS или NRF_ERROR_NOT_FOUND (страница пуста или повреждена)
+ */
+ret_code_t color_calib_load(void);
+
+/**
+ * @brief Записывает текущую калибровку во flash
+ *
+ * Стирание страницы останавливает CPU на ~85 мс, PWM продолжает работать
+ * через EasyDMA. Если во flash уже та же калибровка, страница не стирается.
+ *
+ * @return NRF_SUCCESS или NRF_ERROR_INTERNAL (не прошла проверка записи)
+ */
+ret_code_t color_calib_save(void);
+
+/**
+ * @brief Уровни модели -> значения PWM с калибровкой за один проход
+ *
+ * Уровни умножаются на матрицу, уже масштабированную предельными
+ * уровнями, и переводятся в значения PWM.
+ *
+ * @param p_channels Уровни каналов модели, Q15
+ * @param full_scale Значение PWM, соответствующее 100%
+ * @param p_out Значения PWM для R, G, B
+ */
+void color_calib_apply(color_channels_t const * p_channels, uint32_t full_scale, uint32_t p_out[3]);
+
+#endif // COLOR_CALIB_H__
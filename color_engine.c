@@ -0,0 +1,67 @@
+#include "color_calib.h"
+#include "color_engine.h"
+
+/**
+ * @brief Ограничение целого значения в диапазоне
+ */
+static inline int clamp_value(int value, int min, int max) {
+    if (value < min) return min;
+    if (value > max) return max;
+    return value;
+}
+
+/**
+ * @brief Конвертация уровня Q15 в яркость выхода
+ * @param level Уровень 0..COLOR_MODEL_LEVEL_MAX
+ * @param full_scale Значение, соответствующее 100%
+ */
+static inline uint32_t level_to_output(uint32_t level, uint32_t full_scale) {
+    return (uint32_t)(((uint64_t)level * full_scale + COLOR_MODEL_LEVEL_MAX / 2) / COLOR_MODEL_LEVEL_MAX);
+}
+
+/**
+ * @brief Состояние -> координаты модели -> каналы с калибровкой
+ */
+static void state_to_rgb(color_model_t model, app_state_t const * p_state, uint32_t full_scale, uint32_t rgb[3]) {
+    color_coord_t coord = {
+        .a = (uint16_t)clamp_value((int)(p_state->hue * COLOR_MODEL_HUE_MAX / 360.0f), 0, COLOR_MODEL_HUE_MAX - 1),
+        .b = (uint16_t)(clamp_value(p_state->saturation, 0, 100) * COLOR_MODEL_LEVEL_MAX / 100),
+        .c = (uint16_t)(clamp_value(p_state->value, 0, 100) * COLOR_MODEL_LEVEL_MAX / 100)
+    };
+    color_channels_t channels;
+
+    color_model_convert(model, &coord, &channels);
+
+    // Калибровка экземпляра и перевод в яркость выхода - одним проходом
+    color_calib_apply(&channels, full_scale, rgb);
+}
+
+void color_engine_init(color_engine_t * p_engine, color_model_t model) {
+    p_engine->model = model;
+    p_engine->fade_active = false;
+}
+
+void color_engine_fade_in(color_engine_t * p_engine, app_state_t const * p_state, uint32_t duration_ms) {
+    uint32_t from[3];
+
+    state_to_rgb(p_engine->model, p_state, COLOR_MODEL_LEVEL_MAX, from);
+    for (int i = 0; i < 3; i++) {
+        from[i] = from[i] * COLOR_ENGINE_FADE_START_PERCENT / 100;
+    }
+    oklab_transition_start(&p_engine->fade, from, duration_ms, false);
+    p_engine->fade_active = true;
+}
+
+void color_engine_output(color_engine_t * p_engine, app_state_t const * p_state,
+                         uint32_t full_scale, uint32_t elapsed_ms, uint32_t rgb[3]) {
+    if (p_engine->fade_active) {
+        // Переход в OKLab: светлота меняется равномерно для глаза
+        state_to_rgb(p_engine->model, p_state, COLOR_MODEL_LEVEL_MAX, rgb);
+        p_engine->fade_active = oklab_transition_step(&p_engine->fade, rgb, elapsed_ms, rgb);
+        for (int i = 0; i < 3; i++) {
+            rgb[i] = level_to_output(rgb[i], full_scale);
+        }
+    } else {
+        state_to_rgb(p_engine->model, p_state, full_scale, rgb);
+    }
+}
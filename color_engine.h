@@ -0,0 +1,57 @@
+#ifndef COLOR_ENGINE_H__
+#define COLOR_ENGINE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "app_state.h"
+#include "color_model.h"
+#include "oklab.h"
+
+/**
+ * @brief Состояние преобразования цвета в яркости каналов
+ */
+typedef struct {
+    color_model_t      model;       /**< Цветовая модель светодиода */
+    oklab_transition_t fade;        /**< Переход цвета в OKLab */
+    bool               fade_active; /**< Переход идёт */
+} color_engine_t;
+
+/**
+ * @brief Начальное состояние без перехода
+ * @param p_engine Состояние
+ * @param model Цветовая модель светодиода
+ */
+void color_engine_init(color_engine_t * p_engine, color_model_t model);
+
+#define COLOR_ENGINE_FADE_START_PERCENT 50  /**< Начальная яркость плавного включения, % от цвета состояния */
+
+/**
+ * @brief Плавное включение цвета состояния
+ *
+ * Начинается не из чёрного, а с COLOR_ENGINE_FADE_START_PERCENT яркости
+ * того же цвета (в OKLab это ~80% светлоты): первый кадр уже светится,
+ * даже если следующие задерживаются до запуска таймеров.
+ *
+ * @param p_engine Состояние
+ * @param p_state Состояние приложения, к цвету которого идёт переход
+ * @param duration_ms Длительность
+ */
+void color_engine_fade_in(color_engine_t * p_engine, app_state_t const * p_state, uint32_t duration_ms);
+
+/**
+ * @brief Яркости RGB светодиода для состояния
+ *
+ * Три редактируемых значения - координаты модели (для CCT: температура,
+ * tint и яркость). Результат проходит через калибровку экземпляра платы
+ * (color_calib).
+ *
+ * @param p_engine Состояние; переход продвигается на elapsed_ms
+ * @param p_state Состояние приложения
+ * @param full_scale Значение, соответствующее 100%
+ * @param elapsed_ms Время с прошлого вызова
+ * @param rgb Яркости красного, зелёного и синего
+ */
+void color_engine_output(color_engine_t * p_engine, app_state_t const * p_state,
+                         uint32_t full_scale, uint32_t elapsed_ms, uint32_t rgb[3]);
+
+#endif // COLOR_ENGINE_H__
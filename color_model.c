@@ -0,0 +1,188 @@
+#include "nrf.h"
+#include "app_util.h"
+#include "cycle_counter.h"
+#include "color_model.h"
+#include "oklab.h"
+
+#define CCT_TABLE_STEP_K    500     /**< Шаг таблицы цветовой температуры */
+
+/* RGB излучения чёрного тела (аппроксимация Таннера Хелланда), Q15,
+ * от COLOR_MODEL_CCT_MIN_K до COLOR_MODEL_CCT_MAX_K с шагом CCT_TABLE_STEP_K */
+static const uint16_t m_cct_table[][3] = {
+    { 32767,  8728,     0 },    /* 1000 K */
+    { 32767, 13910,     0 },    /* 1500 K */
+    { 32767, 17587,  1787 },    /* 2000 K */
+    { 32767, 20439,  9004 },    /* 2500 K */
+    { 32767, 22770, 14124 },    /* 3000 K */
+    { 32767, 24740, 18096 },    /* 3500 K */
+    { 32767, 26447, 21341 },    /* 4000 K */
+    { 32767, 27952, 24085 },    /* 4500 K */
+    { 32767, 29299, 26462 },    /* 5000 K */
+    { 32767, 30517, 28558 },    /* 5500 K */
+    { 32767, 31630, 30433 },    /* 6000 K */
+    { 32767, 32653, 32130 },    /* 6500 K */
+    { 31175, 31114, 32767 },    /* 7000 K */
+    { 29536, 30176, 32767 },    /* 7500 K */
+    { 28426, 29527, 32767 },    /* 8000 K */
+    { 27593, 29034, 32767 },    /* 8500 K */
+    { 26931, 28637, 32767 },    /* 9000 K */
+    { 26384, 28306, 32767 },    /* 9500 K */
+    { 25919, 28022, 32767 },    /* 10000 K */
+};
+
+STATIC_ASSERT(ARRAY_SIZE(m_cct_table) ==
+              (COLOR_MODEL_CCT_MAX_K - COLOR_MODEL_CCT_MIN_K) / CCT_TABLE_STEP_K + 1,
+              "CCT table does not cover the range");
+
+/**
+ * @brief Умножение уровней Q15 с округлением
+ */
+static inline uint32_t q15_mul(uint32_t x, uint32_t y) {
+    return (x * y + (1UL << (COLOR_MODEL_LEVEL_BITS - 1))) >> COLOR_MODEL_LEVEL_BITS;
+}
+
+static void hsv_convert(color_coord_t const * p_coord, color_channels_t * p_out) {
+    uint32_t r, g, b;
+
+    color_hsv_to_rgb(p_coord->a, p_coord->b, p_coord->c, COLOR_MODEL_LEVEL_BITS, &r, &g, &b);
+    p_out->r = (uint16_t)r;
+    p_out->g = (uint16_t)g;
+    p_out->b = (uint16_t)b;
+}
+
+/**
+ * HSL сводится к HSV: v = l + s * min(l, 1 - l), s_v = 2 * (1 - l / v).
+ */
+static void hsl_convert(color_coord_t const * p_coord, color_channels_t * p_out) {
+    uint32_t l = p_coord->c;
+    uint32_t m = l < COLOR_MODEL_LEVEL_MAX - l ? l : COLOR_MODEL_LEVEL_MAX - l;
+    uint32_t v = l + q15_mul(p_coord->b, m);
+    uint32_t s = 0;
+
+    if (v > 0) {
+        s = 2 * (v - l) * COLOR_MODEL_LEVEL_MAX / v;
+        if (s > COLOR_MODEL_LEVEL_MAX) {
+            s = COLOR_MODEL_LEVEL_MAX;
+        }
+    }
+
+    color_coord_t hsv = { .a = p_coord->a, .b = (uint16_t)s, .c = (uint16_t)v };
+    hsv_convert(&hsv, p_out);
+}
+
+/**
+ * Температура интерполируется по таблице чёрного тела. Tint сдвигает цвет
+ * вдоль зелёный-пурпурный: выше середины ослабляются R и B, ниже - G.
+ */
+static void cct_convert(color_coord_t const * p_coord, color_channels_t * p_out) {
+    uint32_t kelvin = COLOR_MODEL_CCT_MIN_K +
+        (uint32_t)p_coord->a * (COLOR_MODEL_CCT_MAX_K - COLOR_MODEL_CCT_MIN_K) / (COLOR_MODEL_HUE_MAX - 1);
+    uint32_t offset = kelvin - COLOR_MODEL_CCT_MIN_K;
+    uint32_t index = offset / CCT_TABLE_STEP_K;
+    uint32_t frac = offset % CCT_TABLE_STEP_K;
+    uint32_t rgb[3];
+
+    if (index >= ARRAY_SIZE(m_cct_table) - 1) {
+        index = ARRAY_SIZE(m_cct_table) - 2;
+        frac = CCT_TABLE_STEP_K;
+    }
+
+    for (int ch = 0; ch < 3; ch++) {
+        int32_t lo = m_cct_table[index][ch];
+        int32_t hi = m_cct_table[index + 1][ch];
+        rgb[ch] = (uint32_t)(lo + (hi - lo) * (int32_t)frac / CCT_TABLE_STEP_K);
+    }
+
+    int32_t tint = (int32_t)p_coord->b - (COLOR_MODEL_LEVEL_MAX + 1) / 2;
+    if (tint > 0) {
+        uint32_t keep = COLOR_MODEL_LEVEL_MAX - (uint32_t)tint;
+        rgb[0] = q15_mul(rgb[0], keep);
+        rgb[2] = q15_mul(rgb[2], keep);
+    } else if (tint < 0) {
+        rgb[1] = q15_mul(rgb[1], COLOR_MODEL_LEVEL_MAX - (uint32_t)(-tint));
+    }
+
+    p_out->r = (uint16_t)q15_mul(rgb[0], p_coord->c);
+    p_out->g = (uint16_t)q15_mul(rgb[1], p_coord->c);
+    p_out->b = (uint16_t)q15_mul(rgb[2], p_coord->c);
+}
+
+/**
+ * Оттенок OKLCH меняется равномерно для глаза при постоянных светлоте и
+ * цветности, поэтому удержание кнопки в режиме оттенка не проходит через
+ * тёмные и "грязные" участки, как линейный оттенок HSV.
+ */
+static void oklch_convert(color_coord_t const * p_coord, color_channels_t * p_out) {
+    oklch_t lch = {
+        .L = p_coord->c,
+        .C = (int32_t)((uint32_t)p_coord->b * OKLAB_CHROMA_MAX / COLOR_MODEL_LEVEL_MAX),
+        .h = (uint16_t)((uint32_t)p_coord->a * OKLAB_HUE_TURN / COLOR_MODEL_HUE_MAX)
+    };
+    oklab_t lab;
+    uint32_t r, g, b;
+
+    oklab_from_oklch(&lch, &lab);
+    oklab_to_rgb(&lab, &r, &g, &b);
+    p_out->r = (uint16_t)r;
+    p_out->g = (uint16_t)g;
+    p_out->b = (uint16_t)b;
+}
+
+static const color_model_desc_t m_models[COLOR_MODEL_COUNT] = {
+    [COLOR_MODEL_HSV]   = { .name = "HSV",   .convert = hsv_convert },
+    [COLOR_MODEL_HSL]   = { .name = "HSL",   .convert = hsl_convert },
+    [COLOR_MODEL_CCT]   = { .name = "CCT",   .convert = cct_convert },
+    [COLOR_MODEL_OKLCH] = { .name = "OKLCH", .convert = oklch_convert },
+};
+
+const color_model_desc_t * color_model_get(color_model_t model) {
+    return &m_models[model];
+}
+
+void color_model_convert(color_model_t model, color_coord_t const * p_coord, color_channels_t * p_out) {
+    m_models[model].convert(p_coord, p_out);
+}
+
+/**
+ * @brief Пустое преобразование для замера накладных расходов цикла
+ */
+static void null_convert(color_coord_t const * p_coord, color_channels_t * p_out) {
+    (void)p_coord;
+    p_out->r = p_out->g = p_out->b = 0;
+}
+
+/**
+ * @brief Прогон преобразования по перебору координат
+ * @return Затраченные такты
+ */
+static uint32_t __attribute__((noinline)) benchmark_run(void (*convert)(color_coord_t const *, color_channels_t *),
+                                                        uint32_t conversions) {
+    volatile uint16_t sink = 0;
+    color_channels_t out;
+    uint32_t start = cycle_counter_get();
+
+    for (uint32_t i = 0; i < conversions; i++) {
+        color_coord_t coord = {
+            .a = (uint16_t)((i * 37) % COLOR_MODEL_HUE_MAX),
+            .b = (uint16_t)((i * 4099) & COLOR_MODEL_LEVEL_MAX),
+            .c = (uint16_t)((i * 8191) & COLOR_MODEL_LEVEL_MAX),
+        };
+        convert(&coord, &out);
+        sink = out.r;
+    }
+
+    (void)sink;
+    return cycle_counter_get() - start;
+}
+
+void color_model_benchmark(color_model_t model, uint32_t conversions, color_model_benchmark_t * p_result) {
+    cycle_counter_init();
+
+    // Перебор координат и косвенный вызов вычитаются
+    uint32_t overhead = benchmark_run(null_convert, conversions);
+    uint32_t total = benchmark_run(m_models[model].convert, conversions);
+
+    p_result->conversions = conversions;
+    p_result->cycles = total > overhead ? total - overhead : 0;
+    p_result->cycles_per_conversion = conversions ? p_result->cycles / conversions : 0;
+}
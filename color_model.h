@@ -0,0 +1,122 @@
+#ifndef COLOR_MODEL_H__
+#define COLOR_MODEL_H__
+
+#include <stdint.h>
+
+#define COLOR_MODEL_HUE_SECTOR  256     /**< Шаг оттенка на сектор цветового круга (60°) */
+#define COLOR_MODEL_HUE_MAX     (6 * COLOR_MODEL_HUE_SECTOR)   /**< Оттенок 360°, не включая */
+#define COLOR_MODEL_LEVEL_BITS  15      /**< Разрядность уровней: Q15 */
+#define COLOR_MODEL_LEVEL_MAX   ((1 << COLOR_MODEL_LEVEL_BITS) - 1) /**< 100% */
+
+#define COLOR_MODEL_CCT_MIN_K   1000    /**< Нижняя граница цветовой температуры */
+#define COLOR_MODEL_CCT_MAX_K   10000   /**< Верхняя граница цветовой температуры */
+
+/**
+ * @brief Цветовые модели
+ */
+typedef enum {
+    COLOR_MODEL_HSV = 0,    /**< Оттенок, насыщенность, яркость -> RGB */
+    COLOR_MODEL_HSL,        /**< Оттенок, насыщенность, светлота -> RGB */
+    COLOR_MODEL_CCT,        /**< Цветовая температура и оттенок (tint) -> RGB */
+    COLOR_MODEL_OKLCH,      /**< Оттенок, цветность, светлота OKLCH -> RGB */
+    COLOR_MODEL_COUNT
+} color_model_t;
+
+/**
+ * @brief Координаты цвета, общие для всех моделей
+ *
+ * Три значения задаются теми же режимами ввода, что и HSV. Первая
+ * координата - положение на круге 0..COLOR_MODEL_HUE_MAX-1 (для CCT -
+ * температура от COLOR_MODEL_CCT_MIN_K до COLOR_MODEL_CCT_MAX_K), две
+ * другие - уровни Q15.
+ */
+typedef struct {
+    uint16_t a;     /**< HSV/HSL/OKLCH: оттенок; CCT: температура */
+    uint16_t b;     /**< HSV/HSL: насыщенность; CCT: tint (середина - нейтральный); OKLCH: цветность */
+    uint16_t c;     /**< HSV/CCT: яркость; HSL/OKLCH: светлота */
+} color_coord_t;
+
+/**
+ * @brief Уровни каналов RGB светодиода, Q15
+ */
+typedef struct {
+    uint16_t r;
+    uint16_t g;
+    uint16_t b;
+} color_channels_t;
+
+/**
+ * @brief Описание модели
+ */
+typedef struct {
+    const char * name;      /**< Имя модели */
+    void (*convert)(color_coord_t const * p_coord, color_channels_t * p_out);   /**< Преобразование */
+} color_model_desc_t;
+
+/**
+ * @brief Стоимость преобразования
+ */
+typedef struct {
+    uint32_t conversions;           /**< Выполнено преобразований */
+    uint32_t cycles;                /**< Всего тактов */
+    uint32_t cycles_per_conversion; /**< Тактов на одно преобразование */
+} color_model_benchmark_t;
+
+/**
+ * @brief Целочисленное HSV -> RGB, общее для всех моделей и кадра пикселей
+ *
+ * Сектор и позиция в нём берутся из старшего и младшего байтов оттенка:
+ *   p = v - ceil(v * s / 2^bits)               - минимум сектора
+ *   q = (v * (256 - f) + p * f + 128) >> 8     - спад от v к p
+ *   t = (p * (256 - f) + v * f + 128) >> 8     - рост от p к v
+ *
+ * @param hue Оттенок 0..COLOR_MODEL_HUE_MAX-1
+ * @param saturation Насыщенность 0..2^bits-1
+ * @param value Яркость 0..2^bits-1
+ * @param bits Разрядность уровней (не более 15)
+ */
+static inline void color_hsv_to_rgb(uint32_t hue, uint32_t saturation, uint32_t value, uint32_t bits,
+                                    uint32_t * p_r, uint32_t * p_g, uint32_t * p_b) {
+    uint32_t f = hue & 0xFF;
+    uint32_t p = value - ((value * saturation + (1UL << bits) - 1) >> bits);
+    uint32_t q = (value * (256 - f) + p * f + 128) >> 8;
+    uint32_t t = (p * (256 - f) + value * f + 128) >> 8;
+
+    switch (hue >> 8) {
+        case 0:  *p_r = value; *p_g = t; *p_b = p; break;
+        case 1:  *p_r = q; *p_g = value; *p_b = p; break;
+        case 2:  *p_r = p; *p_g = value; *p_b = t; break;
+        case 3:  *p_r = p; *p_g = q; *p_b = value; break;
+        case 4:  *p_r = t; *p_g = p; *p_b = value; break;
+        default: *p_r = value; *p_g = p; *p_b = q; break;
+    }
+}
+
+/**
+ * @brief Описание модели
+ * @param model Модель
+ */
+const color_model_desc_t * color_model_get(color_model_t model);
+
+/**
+ * @brief Преобразование координат модели в уровни каналов
+ * @param model Модель
+ * @param p_coord Координаты
+ * @param p_out Уровни каналов Q15
+ */
+void color_model_convert(color_model_t model, color_coord_t const * p_coord, color_channels_t * p_out);
+
+/**
+ * @brief Замер стоимости преобразования модели
+ *
+ * Координаты перебираются по всему диапазону, чтобы пройти все ветви;
+ * время берётся из DWT CYCCNT за вычетом такого же цикла с пустым
+ * преобразованием.
+ *
+ * @param model Модель
+ * @param conversions Количество преобразований
+ * @param p_result Результат
+ */
+void color_model_benchmark(color_model_t model, uint32_t conversions, color_model_benchmark_t * p_result);
+
+#endif // COLOR_MODEL_H__
@@ -0,0 +1,86 @@
+#ifndef CYCLE_COUNTER_H__
+#define CYCLE_COUNTER_H__
+
+#include <stdint.h>
+#include "nrf.h"
+
+#ifndef CYCLE_COUNTER_SYSTICK
+#define CYCLE_COUNTER_SYSTICK   0   /**< Счёт по SysTick вместо DWT (QEMU: DWT CYCCNT не моделируется) */
+#endif
+
+#if CYCLE_COUNTER_SYSTICK
+
+#ifndef CYCLE_COUNTER_FREQ_HZ
+#define CYCLE_COUNTER_FREQ_HZ   1000000000UL    /**< QEMU -icount shift=0: одна инструкция - 1 нс */
+#endif
+
+#ifndef CYCLE_COUNTER_SYSTICK_SCALE
+#define CYCLE_COUNTER_SYSTICK_SCALE 40  /**< Инструкций на такт SysTick (25 МГц mps2-an386 при -icount shift=0) */
+#endif
+
+extern volatile uint32_t cycle_counter_systick_wraps;   /**< Переполнения SysTick (считает SysTick_Handler) */
+
+/**
+ * @brief Запускает SysTick на полный 24-битный период с прерыванием переполнения
+ *
+ * Повторный вызов ничего не меняет: замеры считают разности от своих отметок.
+ */
+static inline void cycle_counter_init(void) {
+    if (SysTick->CTRL & SysTick_CTRL_ENABLE_Msk) {
+        return;
+    }
+    SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+    SysTick->VAL = 0;
+    cycle_counter_systick_wraps = 0;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+}
+
+/**
+ * @brief Текущее значение счётчика в инструкциях
+ */
+static inline uint32_t cycle_counter_get(void) {
+    uint32_t wraps;
+    uint32_t value;
+
+    do {
+        wraps = cycle_counter_systick_wraps;
+        value = SysTick->VAL;
+    } while (wraps != cycle_counter_systick_wraps);
+
+    return ((wraps << 24) + (SysTick_LOAD_RELOAD_Msk - value)) * CYCLE_COUNTER_SYSTICK_SCALE;
+}
+
+#else
+
+#define CYCLE_COUNTER_FREQ_HZ   64000000UL  /**< Частота счётчика DWT CYCCNT (тактовая частота ядра) */
+
+/**
+ * @brief Включает счётчик тактов ядра DWT CYCCNT
+ *
+ * Счётчик останавливается, пока процессор спит в WFE/WFI, поэтому
+ * показывает только активное время. Значение не сбрасывается: счётчик
+ * общий для boot_timing, power_monitor и замеров, и каждый из них
+ * считает разность со своей отметкой.
+ */
+static inline void cycle_counter_init(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief Текущее значение счётчика тактов
+ */
+static inline uint32_t cycle_counter_get(void) {
+    return DWT->CYCCNT;
+}
+
+#endif
+
+/**
+ * @brief Перевод тактов в микросекунды
+ */
+static inline uint64_t cycle_counter_to_us(uint64_t cycles) {
+    return cycles / (CYCLE_COUNTER_FREQ_HZ / 1000000UL);
+}
+
+#endif // CYCLE_COUNTER_H__
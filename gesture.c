@@ -0,0 +1,86 @@
+#include "gesture.h"
+
+/**
+ * @brief Срок наступил (с учётом переполнения времени)
+ */
+static inline bool time_reached(uint32_t now_ms, uint32_t deadline_ms) {
+    return (int32_t)(now_ms - deadline_ms) >= 0;
+}
+
+/**
+ * @brief Снимает истёкшие сроки
+ *
+ * Флаги не дают сроку, оставшемуся с прошлой серии, снова оказаться
+ * "в будущем" после переполнения времени.
+ */
+static void deadlines_update(gesture_t * p_gesture, uint32_t now_ms) {
+    if (p_gesture->debouncing && time_reached(now_ms, p_gesture->debounce_end_ms)) {
+        p_gesture->debouncing = false;
+    }
+    if (p_gesture->clicks > 0 && time_reached(now_ms, p_gesture->window_end_ms)) {
+        p_gesture->clicks = 0;
+    }
+}
+
+void gesture_init(gesture_t * p_gesture) {
+    p_gesture->debounce_end_ms = 0;
+    p_gesture->window_end_ms = 0;
+    p_gesture->clicks = 0;
+    p_gesture->debouncing = false;
+    p_gesture->hold = false;
+}
+
+gesture_event_t gesture_press(gesture_t * p_gesture, uint32_t now_ms) {
+    deadlines_update(p_gesture, now_ms);
+
+    // Пропуск во время антидребезга
+    if (p_gesture->debouncing) {
+        return GESTURE_NONE;
+    }
+
+    p_gesture->debouncing = true;
+    p_gesture->debounce_end_ms = now_ms + GESTURE_DEBOUNCE_MS;
+    p_gesture->hold = true;
+
+    switch (p_gesture->clicks) {
+        case 0:
+            p_gesture->clicks = 1;
+            p_gesture->window_end_ms = now_ms + GESTURE_CLICK_WINDOW_MS;
+            return GESTURE_CLICK;
+
+        case 1:
+            // Окно ожидания третьего клика
+            p_gesture->clicks = 2;
+            p_gesture->window_end_ms = now_ms + GESTURE_CLICK_WINDOW_MS;
+            return GESTURE_DOUBLE_CLICK;
+
+        default:
+            p_gesture->clicks = 0;
+            return GESTURE_TRIPLE_CLICK;
+    }
+}
+
+bool gesture_check(gesture_t const * p_gesture, uint32_t now_ms) {
+    if (p_gesture->clicks > 2) {
+        return false;
+    }
+    if (p_gesture->clicks > 0
+        && (time_reached(now_ms, p_gesture->window_end_ms)
+            || p_gesture->window_end_ms - now_ms > GESTURE_CLICK_WINDOW_MS)) {
+        return false;
+    }
+    if (p_gesture->debouncing
+        && (time_reached(now_ms, p_gesture->debounce_end_ms)
+            || p_gesture->debounce_end_ms - now_ms > GESTURE_DEBOUNCE_MS)) {
+        return false;
+    }
+    return true;
+}
+
+void gesture_poll(gesture_t * p_gesture, uint32_t now_ms, bool pressed) {
+    deadlines_update(p_gesture, now_ms);
+
+    if (p_gesture->hold && !pressed) {
+        p_gesture->hold = false;
+    }
+}
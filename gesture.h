@@ -0,0 +1,79 @@
+#ifndef GESTURE_H__
+#define GESTURE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef GESTURE_DEBOUNCE_MS
+#define GESTURE_DEBOUNCE_MS     200     /**< Время антидребезга в миллисекундах */
+#endif
+
+#ifndef GESTURE_CLICK_WINDOW_MS
+#define GESTURE_CLICK_WINDOW_MS 500     /**< Окно ожидания следующего клика серии */
+#endif
+
+/**
+ * @brief Распознанное нажатие
+ */
+typedef enum {
+    GESTURE_NONE = 0,       /**< Дребезг - нажатие отброшено */
+    GESTURE_CLICK,          /**< Первый клик серии */
+    GESTURE_DOUBLE_CLICK,   /**< Второй клик в окне первого */
+    GESTURE_TRIPLE_CLICK    /**< Третий клик в окне второго */
+} gesture_event_t;
+
+/**
+ * @brief Состояние распознавателя кнопки
+ *
+ * Сроки - абсолютное время в мс; таймеры не нужны: истёкшие сроки
+ * замечают gesture_press() и gesture_poll().
+ */
+typedef struct {
+    uint32_t debounce_end_ms;   /**< Конец антидребезга */
+    uint32_t window_end_ms;     /**< Конец окна следующего клика */
+    uint8_t  clicks;            /**< Кликов в текущей серии (0-2) */
+    bool     debouncing;        /**< Нажатия до debounce_end_ms отбрасываются */
+    bool     hold;              /**< Кнопка удерживается после принятого нажатия */
+} gesture_t;
+
+/**
+ * @brief Начальное состояние: серии нет, кнопка отпущена
+ */
+void gesture_init(gesture_t * p_gesture);
+
+/**
+ * @brief Нажатие кнопки (фронт)
+ * @param p_gesture Состояние
+ * @param now_ms Время нажатия
+ * @return Распознанный клик или GESTURE_NONE
+ */
+gesture_event_t gesture_press(gesture_t * p_gesture, uint32_t now_ms);
+
+/**
+ * @brief Периодическая проверка: истечение сроков и отпускание кнопки
+ * @param p_gesture Состояние
+ * @param now_ms Текущее время
+ * @param pressed Кнопка нажата сейчас
+ */
+void gesture_poll(gesture_t * p_gesture, uint32_t now_ms, bool pressed);
+
+/**
+ * @brief Проверка инвариантов после gesture_press() или gesture_poll()
+ *
+ * Серия не длиннее двух кликов, а незавершённые сроки лежат в будущем не
+ * дальше своей длительности: ни один срок не "завис".
+ *
+ * @param p_gesture Состояние
+ * @param now_ms Время последнего вызова
+ * @return true - состояние допустимо
+ */
+bool gesture_check(gesture_t const * p_gesture, uint32_t now_ms);
+
+/**
+ * @brief Кнопка удерживается после принятого нажатия
+ */
+static inline bool gesture_hold(gesture_t const * p_gesture) {
+    return p_gesture->hold;
+}
+
+#endif // GESTURE_H__
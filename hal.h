@@ -0,0 +1,123 @@
+#ifndef HAL_H__
+#define HAL_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sdk_errors.h"
+
+/**
+ * @brief Тонкий слой между логикой приложения и периферией
+ *
+ * Четыре части: выходы (индикатор и RGB светодиод), вход (кнопка),
+ * монотонные часы и программные таймеры. Реализация выбирается при
+ * сборке (HAL_BACKEND) и определяет функции как static inline: вызов
+ * через HAL компилируется в те же инструкции, что и прямой вызов
+ * драйвера.
+ *
+ * HAL_BACKEND_NRF - nRF52840 (led_pwm, nrfx_gpiote, app_timer),
+ * HAL_BACKEND_SIM - модель в памяти для сборки логики на хосте.
+ */
+
+#define HAL_BACKEND_NRF     0
+#define HAL_BACKEND_SIM     1
+
+#ifndef HAL_BACKEND
+#define HAL_BACKEND         HAL_BACKEND_NRF     /**< Реализация HAL */
+#endif
+
+/**
+ * @brief Пины выходов
+ */
+typedef struct {
+    uint32_t indicator_pin;     /**< Индикаторный светодиод */
+    uint32_t rgb_pins[3];       /**< Красный, зелёный, синий */
+} hal_output_pins_t;
+
+typedef void (*hal_input_handler_t)(void);              /**< Нажатие кнопки */
+typedef void (*hal_timer_handler_t)(void * p_context);  /**< Срабатывание таймера */
+
+/*
+ * Реализация определяет hal_timer_id_t, макрос HAL_TIMER_DEF(id) и все
+ * функции ниже; объявления ниже проверяют, что она совпадает с интерфейсом.
+ */
+
+#if HAL_BACKEND == HAL_BACKEND_NRF
+#include "hal_nrf.h"
+#elif HAL_BACKEND == HAL_BACKEND_SIM
+#include "hal_sim.h"
+#else
+#error "Unknown HAL_BACKEND"
+#endif
+
+/* ---------------- Выходы ---------------- */
+
+/**
+ * @brief Настраивает выходы; до первого hal_output_set() светодиоды погашены
+ */
+static inline ret_code_t hal_output_init(hal_output_pins_t const * p_pins);
+
+/**
+ * @brief Задаёт все выходы одним кадром
+ * @param indicator Яркость индикатора, 0..hal_output_full_scale_get()
+ * @param rgb Яркости красного, зелёного и синего, 0..hal_output_full_scale_get()
+ */
+static inline void hal_output_set(uint32_t indicator, uint32_t const rgb[3]);
+
+/**
+ * @brief Яркость 100% (разрешение выхода)
+ */
+static inline uint32_t hal_output_full_scale_get(void);
+
+/**
+ * @brief Гасит выходы и отключает пины
+ */
+static inline void hal_output_uninit(void);
+
+/* ---------------- Вход ---------------- */
+
+/**
+ * @brief Настраивает кнопку (активный низкий уровень) с обработчиком нажатия
+ */
+static inline void hal_input_init(uint32_t pin, hal_input_handler_t handler);
+
+/**
+ * @brief Кнопка нажата сейчас
+ */
+static inline bool hal_input_pressed(uint32_t pin);
+
+/**
+ * @brief Отключает обработчик кнопки
+ */
+static inline void hal_input_uninit(uint32_t pin);
+
+/* ---------------- Часы ---------------- */
+
+/**
+ * @brief Монотонное время в миллисекундах (переполняется через ~49 суток)
+ */
+static inline uint32_t hal_clock_ms(void);
+
+/* ---------------- Таймеры ---------------- */
+
+/**
+ * @brief Создаёт таймер
+ * @param p_id Таймер из HAL_TIMER_DEF
+ * @param periodic true - периодический, false - однократный
+ * @param handler Обработчик
+ */
+static inline ret_code_t hal_timer_create(hal_timer_id_t const * p_id, bool periodic, hal_timer_handler_t handler);
+
+/**
+ * @brief Запускает остановленный таймер
+ * @param id Таймер из HAL_TIMER_DEF
+ * @param period_ms Период или задержка в мс
+ * @param p_context Аргумент обработчика
+ */
+static inline ret_code_t hal_timer_start(hal_timer_id_t id, uint32_t period_ms, void * p_context);
+
+/**
+ * @brief Останавливает таймер
+ */
+static inline ret_code_t hal_timer_stop(hal_timer_id_t id);
+
+#endif // HAL_H__
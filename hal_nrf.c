@@ -0,0 +1,141 @@
+#include "nrf.h"
+#include "app_util_platform.h"
+#include "nrfx_pwm.h"
+#include "cycle_counter.h"
+#include "hal.h"
+
+led_pwm_fixture_t hal_nrf_indicator_fixture;
+led_pwm_fixture_t hal_nrf_rgb_fixture;
+
+static hal_input_handler_t m_input_handler;     /**< Обработчик нажатия (кнопка одна) */
+
+static uint32_t m_clock_last_ticks;     /**< Счётчик RTC при прошлом чтении */
+static uint64_t m_clock_ticks;          /**< Тиков RTC с первого чтения */
+
+ret_code_t hal_nrf_output_init(hal_output_pins_t const * p_pins) {
+    led_pwm_fixture_config_t indicator_config = {
+        .channel_count = 1,
+        .pins = { p_pins->indicator_pin }
+    };
+    led_pwm_fixture_config_t rgb_config = {
+        .channel_count = 3,
+        .pins = { p_pins->rgb_pins[0], p_pins->rgb_pins[1], p_pins->rgb_pins[2] }
+    };
+
+    led_pwm_init(PWM_PROFILE, PWM_STAGGER);
+
+    ret_code_t err_code = led_pwm_fixture_add(&indicator_config, &hal_nrf_indicator_fixture);
+    if (err_code != NRF_SUCCESS) {
+        return err_code;
+    }
+    return led_pwm_fixture_add(&rgb_config, &hal_nrf_rgb_fixture);
+}
+
+static void gpiote_handler(nrfx_gpiote_pin_t pin, nrf_gpiote_polarity_t action) {
+    (void)pin;
+    (void)action;
+
+    m_input_handler();
+}
+
+void hal_nrf_input_init(uint32_t pin, hal_input_handler_t handler) {
+    if (!nrfx_gpiote_is_init()) {
+        nrfx_gpiote_init();
+    }
+
+    m_input_handler = handler;
+
+    // Настройка пина кнопки
+    nrf_gpio_cfg_input(pin, NRF_GPIO_PIN_PULLUP);
+
+    // Конфигурация GPIOTE для кнопки
+    nrfx_gpiote_in_config_t input_config = NRFX_GPIOTE_CONFIG_IN_SENSE_HITOLO(true);
+    input_config.pull = NRF_GPIO_PIN_PULLUP;
+
+    nrfx_gpiote_in_init(pin, &input_config, gpiote_handler);
+    nrfx_gpiote_in_event_enable(pin, true);
+}
+
+uint32_t hal_nrf_clock_ms(void) {
+    uint64_t ticks;
+
+    // Счётчик RTC 24-битный (~512 с): расширяется при каждом чтении
+    CRITICAL_REGION_ENTER();
+    uint32_t now = app_timer_cnt_get();
+    m_clock_ticks += app_timer_cnt_diff_compute(now, m_clock_last_ticks);
+    m_clock_last_ticks = now;
+    ticks = m_clock_ticks;
+    CRITICAL_REGION_EXIT();
+
+    return (uint32_t)(ticks * 1000 / APP_TIMER_CLOCK_FREQ);
+}
+
+void hal_nrf_benchmark(uint32_t input_pin, uint32_t iterations, hal_nrf_benchmark_t * p_result) {
+    static const uint32_t black[3] = { 0, 0, 0 };
+    // Буфер EasyDMA прямого вывода; экземпляр 0 уже инициализирован led_pwm
+    static nrf_pwm_values_individual_t direct_values;
+    static const nrfx_pwm_t direct_pwm = NRFX_PWM_INSTANCE(0);
+    volatile uint32_t sink = 0;
+
+    // Промежуточная яркость: через HAL работает путь с запущенным PWM, а не запись пинов
+    uint32_t const full_scale = hal_output_full_scale_get();
+    uint32_t const indicator = full_scale / 2;
+    uint32_t const rgb[3] = { full_scale / 2, full_scale / 2, full_scale / 2 };
+    uint16_t const duty = led_pwm_top_get() / 2;
+
+    cycle_counter_init();
+
+    uint32_t start = cycle_counter_get();
+    for (uint32_t i = 0; i < iterations; i++) {
+        hal_output_set(indicator, rgb);
+    }
+    p_result->output_hal_cycles = (cycle_counter_get() - start) / iterations;
+
+    // Последовательность вызовов до HAL (update_pwm_outputs)
+    start = cycle_counter_get();
+    for (uint32_t i = 0; i < iterations; i++) {
+        direct_values.channel_0 = duty;
+        direct_values.channel_1 = duty;
+        direct_values.channel_2 = duty;
+        direct_values.channel_3 = duty;
+
+        nrf_pwm_sequence_t sequence = {
+            .values.p_individual = &direct_values,
+            .length = NRF_PWM_CHANNEL_COUNT,
+            .repeats = 0,
+            .end_delay = 0
+        };
+        (void)nrfx_pwm_simple_playback(&direct_pwm, &sequence, 1, 0);
+    }
+    p_result->output_direct_cycles = (cycle_counter_get() - start) / iterations;
+
+    // Чёрный кадр останавливает все экземпляры, led_pwm снова владеет экземпляром 0
+    hal_output_set(0, black);
+
+    start = cycle_counter_get();
+    for (uint32_t i = 0; i < iterations; i++) {
+        sink = hal_input_pressed(input_pin);
+    }
+    p_result->input_hal_cycles = (cycle_counter_get() - start) / iterations;
+
+    start = cycle_counter_get();
+    for (uint32_t i = 0; i < iterations; i++) {
+        sink = nrf_gpio_pin_read(input_pin) != 0;
+    }
+    p_result->input_direct_cycles = (cycle_counter_get() - start) / iterations;
+
+    start = cycle_counter_get();
+    for (uint32_t i = 0; i < iterations; i++) {
+        sink = hal_clock_ms();
+    }
+    p_result->clock_hal_cycles = (cycle_counter_get() - start) / iterations;
+
+    // До HAL миллисекунд не было: ближайший источник времени - тики RTC1
+    start = cycle_counter_get();
+    for (uint32_t i = 0; i < iterations; i++) {
+        sink = app_timer_cnt_get();
+    }
+    p_result->clock_direct_cycles = (cycle_counter_get() - start) / iterations;
+
+    (void)sink;
+}
@@ -0,0 +1,100 @@
+#ifndef HAL_NRF_H__
+#define HAL_NRF_H__
+
+#ifndef HAL_H__
+#error "Include hal.h instead of hal_nrf.h"
+#endif
+
+#include "nrf_gpio.h"
+#include "nrfx_gpiote.h"
+#include "app_timer.h"
+#include "led_pwm.h"
+
+typedef app_timer_id_t hal_timer_id_t;  /**< Таймер app_timer */
+
+#define HAL_TIMER_DEF(id)   APP_TIMER_DEF(id)
+
+extern led_pwm_fixture_t hal_nrf_indicator_fixture;    /**< Светильник индикатора */
+extern led_pwm_fixture_t hal_nrf_rgb_fixture;          /**< Светильник RGB */
+
+/**
+ * @brief Стоимость вызова через HAL и последовательности вызовов до HAL, тактов на вызов
+ */
+typedef struct {
+    uint32_t output_hal_cycles;     /**< hal_output_set() с промежуточной яркостью */
+    uint32_t output_direct_cycles;  /**< Четыре скважности и nrfx_pwm_simple_playback() */
+    uint32_t input_hal_cycles;      /**< hal_input_pressed() */
+    uint32_t input_direct_cycles;   /**< nrf_gpio_pin_read() */
+    uint32_t clock_hal_cycles;      /**< hal_clock_ms() */
+    uint32_t clock_direct_cycles;   /**< app_timer_cnt_get() */
+} hal_nrf_benchmark_t;
+
+ret_code_t hal_nrf_output_init(hal_output_pins_t const * p_pins);
+void hal_nrf_input_init(uint32_t pin, hal_input_handler_t handler);
+uint32_t hal_nrf_clock_ms(void);
+
+/**
+ * @brief Замер стоимости HAL против вызовов, которые HAL заменил
+ *
+ * Прямой вывод повторяет код до HAL: скважности каналов и
+ * nrfx_pwm_simple_playback() на экземпляре 0. HAL при этом делает больше
+ * (дизеринг, двойной буфер, все экземпляры), разница - цена этого пути,
+ * а не только вызова. Для часов прямого аналога не было, сравнение идёт
+ * с чтением тиков RTC1.
+ *
+ * Выходы должны быть инициализированы, app_timer запущен. Во время замера
+ * светодиоды горят на половине яркости, в конце гаснут.
+ *
+ * @param input_pin Пин кнопки
+ * @param iterations Вызовов на замер
+ * @param p_result Результат
+ */
+void hal_nrf_benchmark(uint32_t input_pin, uint32_t iterations, hal_nrf_benchmark_t * p_result);
+
+static inline ret_code_t hal_output_init(hal_output_pins_t const * p_pins) {
+    return hal_nrf_output_init(p_pins);
+}
+
+static inline void hal_output_set(uint32_t indicator, uint32_t const rgb[3]) {
+    led_pwm_fixture_set(hal_nrf_indicator_fixture, &indicator);
+    led_pwm_fixture_set(hal_nrf_rgb_fixture, rgb);
+    led_pwm_commit();
+}
+
+static inline uint32_t hal_output_full_scale_get(void) {
+    return led_pwm_full_scale_get();
+}
+
+static inline void hal_output_uninit(void) {
+    led_pwm_uninit();
+}
+
+static inline void hal_input_init(uint32_t pin, hal_input_handler_t handler) {
+    hal_nrf_input_init(pin, handler);
+}
+
+static inline bool hal_input_pressed(uint32_t pin) {
+    return nrf_gpio_pin_read(pin) == 0;
+}
+
+static inline void hal_input_uninit(uint32_t pin) {
+    nrfx_gpiote_in_uninit(pin);
+}
+
+static inline uint32_t hal_clock_ms(void) {
+    return hal_nrf_clock_ms();
+}
+
+static inline ret_code_t hal_timer_create(hal_timer_id_t const * p_id, bool periodic, hal_timer_handler_t handler) {
+    return app_timer_create(p_id, periodic ? APP_TIMER_MODE_REPEATED : APP_TIMER_MODE_SINGLE_SHOT, handler);
+}
+
+static inline ret_code_t hal_timer_start(hal_timer_id_t id, uint32_t period_ms, void * p_context) {
+    return app_timer_start(id, APP_TIMER_TICKS(period_ms), p_context);
+}
+
+static inline ret_code_t hal_timer_stop(hal_timer_id_t id) {
+    return app_timer_stop(id);
+}
+
+#endif // HAL_NRF_H__
@@ -0,0 +1,205 @@
+#undef HAL_BACKEND
+#define HAL_BACKEND HAL_BACKEND_SIM     /**< Этот файл - реализация модели */
+#include <string.h>
+#include "hal.h"
+
+static uint32_t m_now_ms;                       /**< Время модели */
+static hal_sim_timer_t * m_p_timers;            /**< Созданные таймеры */
+static hal_sim_output_t m_output;               /**< Последний кадр выходов */
+static hal_input_handler_t m_input_handler;     /**< Обработчик нажатия */
+static uint32_t m_input_pin;
+static bool m_input_enabled;
+static bool m_input_pressed;
+static hal_sim_trace_t * m_p_trace;             /**< Текущая запись выходов */
+static uint32_t m_trace_ms;                     /**< Время следующего отсчёта */
+
+/**
+ * @brief Время a раньше времени b (с учётом переполнения)
+ */
+static inline bool time_before(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) < 0;
+}
+
+/**
+ * @brief Дописывает отсчёты до момента until_ms (не включая) текущими выходами
+ */
+static void trace_fill(uint32_t until_ms) {
+    if (m_p_trace == NULL) {
+        return;
+    }
+
+    while (time_before(m_trace_ms, until_ms) && m_p_trace->count < m_p_trace->capacity) {
+        hal_sim_sample_t * p_sample = &m_p_trace->p_samples[m_p_trace->count++];
+        p_sample->indicator = m_output.indicator;
+        memcpy(p_sample->rgb, m_output.rgb, sizeof(p_sample->rgb));
+        m_trace_ms++;
+    }
+}
+
+/**
+ * @brief Модуль разности
+ */
+static inline uint32_t distance(uint32_t a, uint32_t b) {
+    return a > b ? a - b : b - a;
+}
+
+void hal_sim_reset(void) {
+    m_now_ms = 0;
+    m_p_timers = NULL;
+    memset(&m_output, 0, sizeof(m_output));
+    m_input_handler = NULL;
+    m_input_enabled = false;
+    m_input_pressed = false;
+    m_p_trace = NULL;
+}
+
+void hal_sim_advance(uint32_t ms) {
+    uint32_t target = m_now_ms + ms;
+
+    while (true) {
+        // Ближайший таймер, срабатывающий не позже target
+        hal_sim_timer_t * p_next = NULL;
+        for (hal_sim_timer_t * p_timer = m_p_timers; p_timer != NULL; p_timer = p_timer->p_next) {
+            if (p_timer->running && !time_before(target, p_timer->deadline_ms)
+                && (p_next == NULL || time_before(p_timer->deadline_ms, p_next->deadline_ms))) {
+                p_next = p_timer;
+            }
+        }
+        if (p_next == NULL) {
+            break;
+        }
+
+        trace_fill(p_next->deadline_ms);
+        m_now_ms = p_next->deadline_ms;
+        if (p_next->periodic) {
+            p_next->deadline_ms += p_next->period_ms;
+        } else {
+            p_next->running = false;
+        }
+        p_next->handler(p_next->p_context);
+    }
+
+    trace_fill(target);
+    m_now_ms = target;
+}
+
+void hal_sim_input_set(bool pressed) {
+    bool press = pressed && !m_input_pressed;
+
+    m_input_pressed = pressed;
+    if (press && m_input_enabled) {
+        m_input_handler();
+    }
+}
+
+void hal_sim_output_get(hal_sim_output_t * p_output) {
+    *p_output = m_output;
+}
+
+void hal_sim_trace_start(hal_sim_trace_t * p_trace, hal_sim_sample_t * p_samples, uint32_t capacity) {
+    p_trace->p_samples = p_samples;
+    p_trace->capacity = capacity;
+    p_trace->count = 0;
+
+    m_p_trace = p_trace;
+    m_trace_ms = m_now_ms;
+}
+
+void hal_sim_trace_stop(void) {
+    m_p_trace = NULL;
+}
+
+int32_t hal_sim_trace_compare(hal_sim_trace_t const * p_trace, hal_sim_trace_t const * p_golden, uint32_t tolerance) {
+    uint32_t count = p_trace->count < p_golden->count ? p_trace->count : p_golden->count;
+
+    for (uint32_t i = 0; i < count; i++) {
+        hal_sim_sample_t const * p_sample = &p_trace->p_samples[i];
+        hal_sim_sample_t const * p_expected = &p_golden->p_samples[i];
+
+        if (distance(p_sample->indicator, p_expected->indicator) > tolerance
+            || distance(p_sample->rgb[0], p_expected->rgb[0]) > tolerance
+            || distance(p_sample->rgb[1], p_expected->rgb[1]) > tolerance
+            || distance(p_sample->rgb[2], p_expected->rgb[2]) > tolerance) {
+            return (int32_t)i;
+        }
+    }
+
+    return p_trace->count == p_golden->count ? -1 : (int32_t)count;
+}
+
+ret_code_t hal_sim_output_init(hal_output_pins_t const * p_pins) {
+    (void)p_pins;
+
+    memset(&m_output, 0, sizeof(m_output));
+    m_output.enabled = true;
+    return NRF_SUCCESS;
+}
+
+void hal_sim_output_set(uint32_t indicator, uint32_t const rgb[3]) {
+    m_output.indicator = indicator;
+    memcpy(m_output.rgb, rgb, sizeof(m_output.rgb));
+    m_output.frames++;
+}
+
+void hal_sim_output_uninit(void) {
+    m_output.enabled = false;
+}
+
+void hal_sim_input_init(uint32_t pin, hal_input_handler_t handler) {
+    m_input_pin = pin;
+    m_input_handler = handler;
+    m_input_enabled = true;
+}
+
+bool hal_sim_input_pressed(uint32_t pin) {
+    return pin == m_input_pin && m_input_pressed;
+}
+
+void hal_sim_input_uninit(uint32_t pin) {
+    if (pin == m_input_pin) {
+        m_input_enabled = false;
+    }
+}
+
+uint32_t hal_sim_clock_ms(void) {
+    return m_now_ms;
+}
+
+ret_code_t hal_sim_timer_create(hal_timer_id_t const * p_id, bool periodic, hal_timer_handler_t handler) {
+    hal_sim_timer_t * p_timer = *p_id;
+
+    if (handler == NULL) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    p_timer->handler = handler;
+    p_timer->periodic = periodic;
+    p_timer->running = false;
+
+    // Повторное создание не добавляет таймер в список второй раз
+    for (hal_sim_timer_t * p_item = m_p_timers; p_item != NULL; p_item = p_item->p_next) {
+        if (p_item == p_timer) {
+            return NRF_SUCCESS;
+        }
+    }
+    p_timer->p_next = m_p_timers;
+    m_p_timers = p_timer;
+    return NRF_SUCCESS;
+}
+
+ret_code_t hal_sim_timer_start(hal_timer_id_t id, uint32_t period_ms, void * p_context) {
+    if (id->handler == NULL || period_ms == 0) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    id->p_context = p_context;
+    id->period_ms = period_ms;
+    id->deadline_ms = m_now_ms + period_ms;
+    id->running = true;
+    return NRF_SUCCESS;
+}
+
+ret_code_t hal_sim_timer_stop(hal_timer_id_t id) {
+    id->running = false;
+    return NRF_SUCCESS;
+}
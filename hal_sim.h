@@ -0,0 +1,163 @@
+#ifndef HAL_SIM_H__
+#define HAL_SIM_H__
+
+#ifndef HAL_H__
+#error "Include hal.h instead of hal_sim.h"
+#endif
+
+#ifndef HAL_SIM_FULL_SCALE
+#define HAL_SIM_FULL_SCALE  64000   /**< Яркость 100% модели выходов (как PWM_PROFILE_STANDARD с дизерингом) */
+#endif
+
+/**
+ * @brief Таймер модели
+ */
+typedef struct hal_sim_timer_s {
+    hal_timer_handler_t handler;
+    void *   p_context;
+    bool     periodic;
+    bool     running;
+    uint32_t period_ms;
+    uint32_t deadline_ms;               /**< Время следующего срабатывания */
+    struct hal_sim_timer_s * p_next;    /**< Список созданных таймеров */
+} hal_sim_timer_t;
+
+typedef hal_sim_timer_t * hal_timer_id_t;   /**< Таймер модели */
+
+#define HAL_TIMER_DEF(id)                                   \
+    static hal_sim_timer_t id##_data;                       \
+    static hal_timer_id_t const id = &id##_data
+
+/**
+ * @brief Последний кадр выходов
+ */
+typedef struct {
+    bool     enabled;       /**< Выходы инициализированы */
+    uint32_t indicator;
+    uint32_t rgb[3];
+    uint32_t frames;        /**< Кадров с hal_output_init() */
+} hal_sim_output_t;
+
+/**
+ * @brief Отсчёт выходов за одну миллисекунду
+ */
+typedef struct {
+    uint32_t indicator;
+    uint32_t rgb[3];
+} hal_sim_sample_t;
+
+/**
+ * @brief Запись выходов с шагом 1 мс
+ *
+ * Отсчёт k - значения, действовавшие на интервале [start + k, start + k + 1) мс
+ * от hal_sim_trace_start(). Запись останавливается при заполнении буфера.
+ */
+typedef struct {
+    hal_sim_sample_t * p_samples;
+    uint32_t capacity;
+    uint32_t count;         /**< Записано отсчётов */
+} hal_sim_trace_t;
+
+/**
+ * @brief Сбрасывает модель: время 0, таймеров и выходов нет, кнопка отпущена
+ */
+void hal_sim_reset(void);
+
+/**
+ * @brief Продвигает время, вызывая обработчики таймеров в порядке срабатывания
+ * @param ms Насколько продвинуть время
+ */
+void hal_sim_advance(uint32_t ms);
+
+/**
+ * @brief Меняет состояние кнопки; нажатие вызывает обработчик входа
+ */
+void hal_sim_input_set(bool pressed);
+
+/**
+ * @brief Последний кадр выходов
+ */
+void hal_sim_output_get(hal_sim_output_t * p_output);
+
+/**
+ * @brief Начинает запись выходов с текущего времени модели
+ *
+ * Отсчёты добавляются при продвижении времени (hal_sim_advance).
+ *
+ * @param p_trace Запись (должна существовать до hal_sim_trace_stop)
+ * @param p_samples Буфер отсчётов
+ * @param capacity Ёмкость буфера, отсчётов
+ */
+void hal_sim_trace_start(hal_sim_trace_t * p_trace, hal_sim_sample_t * p_samples, uint32_t capacity);
+
+/**
+ * @brief Останавливает запись
+ */
+void hal_sim_trace_stop(void);
+
+/**
+ * @brief Сравнивает запись с эталонной
+ * @param p_trace Запись прогона
+ * @param p_golden Эталон
+ * @param tolerance Допустимое отличие каждого выхода, единиц полной шкалы
+ * @return Первый отличающийся отсчёт, -1 - записи совпадают
+ *         (разная длина - отличие в конце более короткой)
+ */
+int32_t hal_sim_trace_compare(hal_sim_trace_t const * p_trace, hal_sim_trace_t const * p_golden, uint32_t tolerance);
+
+ret_code_t hal_sim_output_init(hal_output_pins_t const * p_pins);
+void hal_sim_output_set(uint32_t indicator, uint32_t const rgb[3]);
+void hal_sim_output_uninit(void);
+void hal_sim_input_init(uint32_t pin, hal_input_handler_t handler);
+bool hal_sim_input_pressed(uint32_t pin);
+void hal_sim_input_uninit(uint32_t pin);
+uint32_t hal_sim_clock_ms(void);
+ret_code_t hal_sim_timer_create(hal_timer_id_t const * p_id, bool periodic, hal_timer_handler_t handler);
+ret_code_t hal_sim_timer_start(hal_timer_id_t id, uint32_t period_ms, void * p_context);
+ret_code_t hal_sim_timer_stop(hal_timer_id_t id);
+
+static inline ret_code_t hal_output_init(hal_output_pins_t const * p_pins) {
+    return hal_sim_output_init(p_pins);
+}
+
+static inline void hal_output_set(uint32_t indicator, uint32_t const rgb[3]) {
+    hal_sim_output_set(indicator, rgb);
+}
+
+static inline uint32_t hal_output_full_scale_get(void) {
+    return HAL_SIM_FULL_SCALE;
+}
+
+static inline void hal_output_uninit(void) {
+    hal_sim_output_uninit();
+}
+
+static inline void hal_input_init(uint32_t pin, hal_input_handler_t handler) {
+    hal_sim_input_init(pin, handler);
+}
+
+static inline bool hal_input_pressed(uint32_t pin) {
+    return hal_sim_input_pressed(pin);
+}
+
+static inline void hal_input_uninit(uint32_t pin) {
+    hal_sim_input_uninit(pin);
+}
+
+static inline uint32_t hal_clock_ms(void) {
+    return hal_sim_clock_ms();
+}
+
+static inline ret_code_t hal_timer_create(hal_timer_id_t const * p_id, bool periodic, hal_timer_handler_t handler) {
+    return hal_sim_timer_create(p_id, periodic, handler);
+}
+
+static inline ret_code_t hal_timer_start(hal_timer_id_t id, uint32_t period_ms, void * p_context) {
+    return hal_sim_timer_start(id, period_ms, p_context);
+}
+
+static inline ret_code_t hal_timer_stop(hal_timer_id_t id) {
+    return hal_sim_timer_stop(id);
+}
+
+#endif // HAL_SIM_H__
@@ -0,0 +1,390 @@
+#include "nrf.h"
+#include "sdk_config.h"
+#include "nrf_gpio.h"
+#include "nrfx_pwm.h"
+#include "app_util_platform.h"
+#include "app_error.h"
+#include "power_monitor.h"
+#include "power_profile.h"
+#include "led_pwm.h"
+#include "ws2812.h"
+
+#define LED_PWM_DITHER_PERIODS_MAX (1 << LED_PWM_DITHER_BITS)  /**< Максимальная длина последовательности дизеринга, периодов */
+#define LED_PWM_POLARITY_FALLING   0x8000  /**< Бит 15 значения: период начинается с высокого уровня */
+
+/**
+ * @brief Параметры режима PWM
+ */
+typedef struct {
+    nrf_pwm_clk_t base_clock;   /**< Базовая частота счётчика */
+    uint16_t      top_value;    /**< Значение top (не более 32767) */
+    uint8_t       dither_bits;  /**< Биты дизеринга: последовательность из 2^n периодов */
+} pwm_profile_desc_t;
+
+/* Длина последовательности дизеринга выбрана так, чтобы она повторялась не
+ * реже 250 Гц - ниже начинается заметное мерцание (см. tools/dither_spectrum.py).
+ * Все LED_PWM_DITHER_BITS бит дизеринга требуют PWM не ниже 4 кГц; HIGH_RES
+ * ради 14 бит на 1 кГц использует только 2 */
+static const pwm_profile_desc_t m_profiles[] = {
+    [PWM_PROFILE_STANDARD]    = { .base_clock = NRF_PWM_CLK_16MHz, .top_value = 4000,  .dither_bits = 4 },
+    [PWM_PROFILE_HIGH_RES]    = { .base_clock = NRF_PWM_CLK_16MHz, .top_value = 16000, .dither_bits = 2 },
+    [PWM_PROFILE_CAMERA_SAFE] = { .base_clock = NRF_PWM_CLK_16MHz, .top_value = 1000,  .dither_bits = 4 },
+};
+
+/**
+ * @brief Состояние экземпляра PWM
+ */
+typedef struct {
+    nrfx_pwm_t instance;                    /**< Драйвер nrfx */
+    uint8_t  pins[NRF_PWM_CHANNEL_COUNT];   /**< Пины каналов (NRFX_PWM_PIN_NOT_USED - свободен) */
+    uint8_t  channels_used;                 /**< Занято каналов (выделяются подряд) */
+    bool     initialized;                   /**< nrfx_pwm_init() выполнен */
+    bool     dirty;                         /**< Скважности изменились с последнего кадра */
+    uint8_t  seq_index;                     /**< Буфер, который воспроизводит EasyDMA */
+    uint32_t fine_values[NRF_PWM_CHANNEL_COUNT];    /**< Скважности с дробной частью */
+    nrf_pwm_values_individual_t seq_values[2][LED_PWM_DITHER_PERIODS_MAX]; /**< Двойной буфер последовательности */
+} led_pwm_instance_t;
+
+/**
+ * @brief Размещение светильника
+ */
+typedef struct {
+    uint8_t instance;       /**< Индекс в m_instances */
+    uint8_t first_channel;  /**< Первый канал экземпляра */
+    uint8_t channel_count;  /**< Количество каналов */
+} led_pwm_fixture_slot_t;
+
+static led_pwm_instance_t m_instances[] = {
+#if NRFX_PWM0_ENABLED
+    { .instance = NRFX_PWM_INSTANCE(0) },
+#endif
+#if NRFX_PWM1_ENABLED
+    { .instance = NRFX_PWM_INSTANCE(1) },
+#endif
+#if NRFX_PWM2_ENABLED
+    { .instance = NRFX_PWM_INSTANCE(2) },
+#endif
+#if NRFX_PWM3_ENABLED && !(WS2812_ENABLED && WS2812_PWM_INSTANCE == 3)
+    { .instance = NRFX_PWM_INSTANCE(3) },
+#endif
+};
+
+#define LED_PWM_INSTANCE_COUNT  ARRAY_SIZE(m_instances)
+
+static led_pwm_fixture_slot_t m_fixtures[LED_PWM_FIXTURES_MAX]; /**< Размещённые светильники */
+static uint8_t m_fixture_count = 0;     /**< Количество светильников */
+
+static pwm_profile_t m_profile = PWM_PROFILE;   /**< Текущий режим PWM */
+static bool m_stagger = PWM_STAGGER;            /**< Фазы каналов разнесены (счёт вверх-вниз) */
+static nrf_pwm_clk_t m_base_clock = NRF_PWM_CLK_16MHz;   /**< Базовая частота с учётом разнесения */
+static uint16_t m_top_value = 4000;     /**< Текущее значение top (100% скважности) */
+static uint8_t  m_dither_bits = 4;      /**< Биты дизеринга текущего режима */
+static bool m_running = false;          /**< PWM запущен (иначе выходы - статические уровни GPIO) */
+
+/**
+ * @brief Расчёт тактовой и top для режима
+ *
+ * В режиме с разнесёнными фазами счётчик идёт вверх-вниз: у каналов с
+ * обычной полярностью светодиод горит вокруг начала периода, у каналов с
+ * обратной - вокруг середины, поэтому включения не совпадают и пиковый ток
+ * ниже (см. tools/pwm_current_model.py). Период при этом вдвое длиннее:
+ * частота сохраняется удвоением тактовой, а на 16 МГц - уменьшением top вдвое.
+ */
+static void profile_apply(pwm_profile_t profile) {
+    m_profile = profile;
+    m_base_clock = m_profiles[profile].base_clock;
+    m_top_value = m_profiles[profile].top_value;
+    m_dither_bits = m_profiles[profile].dither_bits;
+
+    if (m_stagger) {
+        if (m_base_clock != NRF_PWM_CLK_16MHz) {
+            m_base_clock = (nrf_pwm_clk_t)(m_base_clock - 1);
+        } else {
+            m_top_value /= 2;
+        }
+    }
+}
+
+/**
+ * @brief Инициализация экземпляра с текущими пинами и режимом
+ */
+static void instance_init(led_pwm_instance_t * p_inst) {
+    nrfx_pwm_config_t pwm_config = NRFX_PWM_DEFAULT_CONFIG;
+    for (int ch = 0; ch < NRF_PWM_CHANNEL_COUNT; ch++) {
+        pwm_config.output_pins[ch] = p_inst->pins[ch];
+    }
+    pwm_config.base_clock = m_base_clock;
+    pwm_config.count_mode = m_stagger ? NRF_PWM_MODE_UP_AND_DOWN : NRF_PWM_MODE_UP;
+    pwm_config.top_value  = m_top_value;
+    pwm_config.load_mode  = NRF_PWM_LOAD_INDIVIDUAL;
+    pwm_config.step_mode  = NRF_PWM_STEP_AUTO;
+
+    APP_ERROR_CHECK(nrfx_pwm_init(&p_inst->instance, &pwm_config, NULL));
+    p_inst->initialized = true;
+
+    for (int ch = 0; ch < NRF_PWM_CHANNEL_COUNT; ch++) {
+        p_inst->fine_values[ch] = 0;
+    }
+    p_inst->dirty = true;
+}
+
+/**
+ * @brief Остановка всех экземпляров
+ * @param uninit true - также освободить драйверы
+ */
+static void instances_stop(bool uninit) {
+    for (uint32_t i = 0; i < LED_PWM_INSTANCE_COUNT; i++) {
+        led_pwm_instance_t * p_inst = &m_instances[i];
+        if (!p_inst->initialized) {
+            continue;
+        }
+        nrfx_pwm_stop(&p_inst->instance, true);
+        if (uninit) {
+            nrfx_pwm_uninit(&p_inst->instance);
+            p_inst->initialized = false;
+        }
+    }
+
+    if (m_running) {
+        m_running = false;
+        power_monitor_pwm_state_set(false);
+        power_profile_pwm_active(false);
+    }
+}
+
+/**
+ * @brief Заполняет последовательность PWM с сигма-дельта дизерингом
+ *
+ * Дробная часть скважности распределяется по 2^n периодам модулятором
+ * первого порядка: в среднем за последовательность получается точное
+ * значение, а ошибка сдвигается на частоту повторения периодов.
+ *
+ * @param p_seq Буфер последовательности
+ * @param p_values Скважности каналов с LED_PWM_DITHER_BITS дробными битами
+ */
+static void sequence_fill(nrf_pwm_values_individual_t * p_seq, uint32_t const * p_values) {
+    uint16_t *p_raw = (uint16_t *)p_seq;
+    uint32_t periods = 1UL << m_dither_bits;
+    uint32_t drop = LED_PWM_DITHER_BITS - m_dither_bits;
+
+    for (int ch = 0; ch < NRF_PWM_CHANNEL_COUNT; ch++) {
+        uint32_t value = (p_values[ch] + ((1UL << drop) >> 1)) >> drop;
+        uint32_t whole = value >> m_dither_bits;
+        uint32_t fraction = value & (periods - 1);
+        uint32_t accumulator = periods / 2;
+
+        for (uint32_t k = 0; k < periods; k++) {
+            uint32_t duty = whole;
+            accumulator += fraction;
+            if (accumulator >= periods) {
+                accumulator -= periods;
+                duty++;
+            }
+            if (duty > m_top_value) {
+                duty = m_top_value;
+            }
+            // Нечётные каналы с обратной полярностью: та же длительность, центр в середине периода
+            if (m_stagger && (ch & 1)) {
+                duty = (m_top_value - duty) | LED_PWM_POLARITY_FALLING;
+            }
+            p_raw[k * NRF_PWM_CHANNEL_COUNT + ch] = (uint16_t)duty;
+        }
+    }
+}
+
+/**
+ * @brief Запуск всех экземпляров с выровненными периодами
+ *
+ * Воспроизведение настраивается без запуска (NRFX_PWM_FLAG_START_VIA_TASK),
+ * затем задачи SEQSTART всех экземпляров запускаются подряд с запрещёнными
+ * прерываниями - периоды при одинаковом режиме начинаются с разницей в
+ * несколько тактов и дальше не расходятся.
+ */
+static void instances_start(void) {
+    uint32_t tasks[LED_PWM_INSTANCE_COUNT];
+    uint32_t task_count = 0;
+
+    for (uint32_t i = 0; i < LED_PWM_INSTANCE_COUNT; i++) {
+        led_pwm_instance_t * p_inst = &m_instances[i];
+        if (!p_inst->initialized) {
+            continue;
+        }
+        sequence_fill(p_inst->seq_values[p_inst->seq_index], p_inst->fine_values);
+
+        nrf_pwm_sequence_t sequence = {
+            .values.p_individual = p_inst->seq_values[p_inst->seq_index],
+            .length = NRF_PWM_CHANNEL_COUNT << m_dither_bits,
+            .repeats = 0,
+            .end_delay = 0
+        };
+        tasks[task_count++] = nrfx_pwm_simple_playback(&p_inst->instance, &sequence, 1,
+                                                       NRFX_PWM_FLAG_LOOP | NRFX_PWM_FLAG_START_VIA_TASK);
+    }
+
+    CRITICAL_REGION_ENTER();
+    for (uint32_t i = 0; i < task_count; i++) {
+        *(volatile uint32_t *)tasks[i] = 1;
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+void led_pwm_init(pwm_profile_t profile, bool stagger) {
+    m_stagger = stagger;
+    profile_apply(profile);
+
+    for (uint32_t i = 0; i < LED_PWM_INSTANCE_COUNT; i++) {
+        for (int ch = 0; ch < NRF_PWM_CHANNEL_COUNT; ch++) {
+            m_instances[i].pins[ch] = NRFX_PWM_PIN_NOT_USED;
+        }
+    }
+}
+
+ret_code_t led_pwm_fixture_add(led_pwm_fixture_config_t const * p_config, led_pwm_fixture_t * p_fixture) {
+    if (p_config->channel_count == 0 || p_config->channel_count > LED_PWM_FIXTURE_CHANNELS_MAX) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if (m_running) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    if (m_fixture_count >= LED_PWM_FIXTURES_MAX) {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    // Первый экземпляр, где хватает свободных каналов
+    for (uint32_t i = 0; i < LED_PWM_INSTANCE_COUNT; i++) {
+        led_pwm_instance_t * p_inst = &m_instances[i];
+        if (NRF_PWM_CHANNEL_COUNT - p_inst->channels_used < p_config->channel_count) {
+            continue;
+        }
+
+        led_pwm_fixture_slot_t * p_slot = &m_fixtures[m_fixture_count];
+        p_slot->instance = (uint8_t)i;
+        p_slot->first_channel = p_inst->channels_used;
+        p_slot->channel_count = p_config->channel_count;
+
+        for (uint8_t k = 0; k < p_config->channel_count; k++) {
+            p_inst->pins[p_slot->first_channel + k] = (uint8_t)p_config->pins[k];
+        }
+        p_inst->channels_used += p_config->channel_count;
+
+        // Пины задаются только при инициализации драйвера
+        if (p_inst->initialized) {
+            nrfx_pwm_uninit(&p_inst->instance);
+        }
+        instance_init(p_inst);
+
+        *p_fixture = m_fixture_count++;
+        return NRF_SUCCESS;
+    }
+
+    return NRF_ERROR_NO_MEM;
+}
+
+void led_pwm_fixture_set(led_pwm_fixture_t fixture, uint32_t const * p_values) {
+    led_pwm_fixture_slot_t const * p_slot = &m_fixtures[fixture];
+    led_pwm_instance_t * p_inst = &m_instances[p_slot->instance];
+
+    for (uint8_t k = 0; k < p_slot->channel_count; k++) {
+        uint32_t * p_value = &p_inst->fine_values[p_slot->first_channel + k];
+        if (*p_value != p_values[k]) {
+            *p_value = p_values[k];
+            p_inst->dirty = true;
+        }
+    }
+}
+
+/**
+ * Если все каналы всех экземпляров полностью выключены или включены, PWM
+ * останавливаются (вместе с ними освобождается HFCLK), а пины держат уровни
+ * GPIO. Уровни записываются в OUT до остановки, поэтому переход происходит
+ * без паузы; при первом же промежуточном значении PWM запускаются снова -
+ * все вместе, чтобы периоды оставались выровненными.
+ *
+ * Иначе последовательности с дизерингом воспроизводятся EasyDMA по кругу
+ * без участия CPU. Новые значения пишутся во второй буфер изменившихся
+ * экземпляров, и указатели последовательностей переключаются на него - PWM
+ * подхватит их на границе последовательности, без обрыва периода.
+ */
+void led_pwm_commit(void) {
+    power_monitor_cause_t prev_cause = power_monitor_enter(POWER_MONITOR_CAUSE_PWM);
+
+    const uint32_t full_scale = led_pwm_full_scale_get();
+    bool all_static = true;
+    for (uint32_t i = 0; i < LED_PWM_INSTANCE_COUNT && all_static; i++) {
+        led_pwm_instance_t const * p_inst = &m_instances[i];
+        for (uint8_t ch = 0; ch < p_inst->channels_used; ch++) {
+            if (p_inst->fine_values[ch] != 0 && p_inst->fine_values[ch] != full_scale) {
+                all_static = false;
+                break;
+            }
+        }
+    }
+
+    if (all_static) {
+        for (uint32_t i = 0; i < LED_PWM_INSTANCE_COUNT; i++) {
+            led_pwm_instance_t const * p_inst = &m_instances[i];
+            // Светодиоды с общим анодом: низкий уровень - горит
+            for (uint8_t ch = 0; ch < p_inst->channels_used; ch++) {
+                nrf_gpio_pin_write(p_inst->pins[ch], p_inst->fine_values[ch] == 0 ? 1 : 0);
+            }
+        }
+        if (m_running) {
+            for (uint32_t i = 0; i < LED_PWM_INSTANCE_COUNT; i++) {
+                if (m_instances[i].initialized) {
+                    nrfx_pwm_stop(&m_instances[i].instance, false);
+                }
+            }
+            m_running = false;
+            power_monitor_pwm_state_set(false);
+            power_profile_pwm_active(false);
+        }
+    } else if (!m_running) {
+        instances_start();
+        m_running = true;
+        power_monitor_pwm_state_set(true);
+        power_profile_pwm_active(true);
+    } else {
+        for (uint32_t i = 0; i < LED_PWM_INSTANCE_COUNT; i++) {
+            led_pwm_instance_t * p_inst = &m_instances[i];
+            if (!p_inst->initialized || !p_inst->dirty) {
+                continue;
+            }
+            // Второй буфер свободен: предыдущая смена была не менее одной последовательности назад
+            p_inst->seq_index ^= 1;
+            sequence_fill(p_inst->seq_values[p_inst->seq_index], p_inst->fine_values);
+
+            nrf_pwm_values_t seq_values = { .p_individual = p_inst->seq_values[p_inst->seq_index] };
+            nrfx_pwm_sequence_values_update(&p_inst->instance, 0, seq_values);
+            nrfx_pwm_sequence_values_update(&p_inst->instance, 1, seq_values);
+        }
+    }
+
+    for (uint32_t i = 0; i < LED_PWM_INSTANCE_COUNT; i++) {
+        m_instances[i].dirty = false;
+    }
+
+    power_monitor_exit(prev_cause);
+}
+
+uint16_t led_pwm_top_get(void) {
+    return m_top_value;
+}
+
+uint32_t led_pwm_full_scale_get(void) {
+    return (uint32_t)m_top_value << LED_PWM_DITHER_BITS;
+}
+
+pwm_profile_t led_pwm_profile_get(void) {
+    return m_profile;
+}
+
+void led_pwm_uninit(void) {
+    instances_stop(true);
+
+    // Без PWM пины остаются выходами - отключаем их, чтобы светодиоды не горели
+    for (uint32_t i = 0; i < LED_PWM_INSTANCE_COUNT; i++) {
+        for (uint8_t ch = 0; ch < m_instances[i].channels_used; ch++) {
+            nrf_gpio_cfg_default(m_instances[i].pins[ch]);
+        }
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef LED_PWM_H__
+#define LED_PWM_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sdk_errors.h"
+
+#define LED_PWM_DITHER_BITS     4   /**< Дробные биты скважности в цветовой математике */
+#define LED_PWM_FIXTURE_CHANNELS_MAX 4  /**< Каналов в одном светильнике (RGBW) */
+#define LED_PWM_FIXTURES_MAX    16  /**< Светильников - не больше, чем каналов у PWM0-PWM3 */
+
+/**
+ * @brief Режимы PWM: базовая частота и значение top (100% скважности)
+ */
+typedef enum {
+    PWM_PROFILE_STANDARD = 0,   /**< 16 МГц / 4000: 4 кГц, ~12 бит + 4 бита дизеринга */
+    PWM_PROFILE_HIGH_RES,       /**< 16 МГц / 16000: 1 кГц, ~14 бит + 2 бита дизеринга (меньше 4: на 1 кГц
+                                     последовательность из 16 периодов повторялась бы с 62,5 Гц) */
+    PWM_PROFILE_CAMERA_SAFE     /**< 16 МГц / 1000: 16 кГц, ~10 бит + 4 бита дизеринга, без биений с затвором камеры */
+} pwm_profile_t;
+
+#ifndef PWM_PROFILE
+#define PWM_PROFILE       PWM_PROFILE_STANDARD  /**< Режим PWM по умолчанию */
+#endif
+
+#ifndef PWM_STAGGER
+#define PWM_STAGGER       0     /**< Разнесение фаз каналов по умолчанию */
+#endif
+
+/**
+ * @brief Описание светильника: набор каналов, управляемых вместе
+ */
+typedef struct {
+    uint8_t  channel_count;                         /**< 1 - одиночный, 3 - RGB, 4 - RGBW */
+    uint32_t pins[LED_PWM_FIXTURE_CHANNELS_MAX];    /**< Пины каналов (активный низкий уровень) */
+} led_pwm_fixture_config_t;
+
+typedef uint8_t led_pwm_fixture_t;  /**< Дескриптор светильника */
+
+/**
+ * @brief Задаёт режим PWM. Экземпляры PWM инициализируются при добавлении светильников.
+ * @param profile Режим PWM
+ * @param stagger true - разнесение фаз каналов (счёт вверх-вниз)
+ */
+void led_pwm_init(pwm_profile_t profile, bool stagger);
+
+/**
+ * @brief Размещает светильник на свободных каналах PWM0-PWM3
+ *
+ * Каналы светильника всегда попадают в один экземпляр PWM (первый, где их
+ * хватает), чтобы его цвет обновлялся одной последовательностью. Вызывается
+ * до первого led_pwm_commit().
+ *
+ * @param p_config Описание светильника
+ * @param p_fixture Дескриптор для led_pwm_fixture_set()
+ * @return NRF_SUCCESS, NRF_ERROR_INVALID_PARAM, NRF_ERROR_NO_MEM или
+ *         NRF_ERROR_INVALID_STATE (PWM уже запущен)
+ */
+ret_code_t led_pwm_fixture_add(led_pwm_fixture_config_t const * p_config, led_pwm_fixture_t * p_fixture);
+
+/**
+ * @brief Задаёт скважности каналов светильника в кадре
+ *
+ * Выходы не меняются до led_pwm_commit().
+ *
+ * @param fixture Дескриптор светильника
+ * @param p_values Скважности с LED_PWM_DITHER_BITS дробными битами, 0..led_pwm_full_scale_get()
+ */
+void led_pwm_fixture_set(led_pwm_fixture_t fixture, uint32_t const * p_values);
+
+/**
+ * @brief Применяет кадр ко всем экземплярам PWM за один проход
+ */
+void led_pwm_commit(void);
+
+/**
+ * @brief Текущее значение top (100% скважности без дробных битов)
+ */
+uint16_t led_pwm_top_get(void);
+
+/**
+ * @brief Скважность 100% с дробными битами
+ */
+uint32_t led_pwm_full_scale_get(void);
+
+/**
+ * @brief Текущий режим PWM
+ */
+pwm_profile_t led_pwm_profile_get(void);
+
+/**
+ * @brief Останавливает PWM и отключает пины всех светильников (перед System OFF)
+ */
+void led_pwm_uninit(void);
+
+#endif // LED_PWM_H__
@@ -1,423 +1,521 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <math.h>
+#include <string.h>
 #include "nrf_gpio.h"
-#include "nrfx_pwm.h"
 #include "nrfx_gpiote.h"
 #include "app_timer.h"
+#include "app_error.h"
+#include "sdk_config.h"
+#include "app_util.h"
 #include "nrfx_clock.h"
-
-/* ---------------- Pins ---------------- */
-#define INDICATOR_LED_PIN NRF_GPIO_PIN_MAP(0,6)
-#define LED_RED     NRF_GPIO_PIN_MAP(0,8)    /**< Пин красного светодиода */
-#define LED_GREEN   NRF_GPIO_PIN_MAP(1,9)    /**< Пин зеленого светодиода */
-#define LED_BLUE    NRF_GPIO_PIN_MAP(0,12)   /**< Пин синего светодиода */
-#define BUTTON_PIN  NRF_GPIO_PIN_MAP(1,6)    /**< Пин кнопки (активный низкий уровень) */
-
-/* ---------------- PWM ---------------- */
-#define PWM_CHANNELS           4    /**< Количество каналов PWM */
-#define DUTY_MAX          1000  /**< Максимальное значение скважности (100%) для ШИМ 1кГц */
+#include "nrf_pwr_mgmt.h"
+#include "power_profile.h"
+#include "mem_monitor.h"
+#include "power_monitor.h"
+#include "system_off.h"
+#include "led_pwm.h"
+#include "ws2812.h"
+#include "pixel_frame.h"
+#include "color_model.h"
+#include "oklab.h"
+#include "color_calib.h"
+#include "usb_cli.h"
+#include "app_state.h"
+#include "boot_timing.h"
+#include "wdt_supervisor.h"
+#include "hal.h"
+#include "app_logic.h"
+#include "ambient.h"
+#include "ambient_filter.h"
+#include "board.h"
+
+/* ---------------- LED strip ---------------- */
+#ifndef WS2812_PIXEL_COUNT
+#define WS2812_PIXEL_COUNT  60      /**< Количество пикселей ленты */
+#endif
+
+#ifndef WS2812_TYPE
+#define WS2812_TYPE         WS2812_TYPE_GRB /**< Тип ленты */
+#endif
+
+#ifndef WS2812_HUE_SPREAD
+#define WS2812_HUE_SPREAD   0       /**< Разброс оттенка вдоль ленты, единицы PIXEL_FRAME_HUE_SECTOR */
+#endif
+
+#ifndef COLOR_MODEL
+#define COLOR_MODEL         COLOR_MODEL_HSV /**< Цветовая модель светодиода */
+#endif
+
+#ifndef COLOR_MODEL_BENCHMARK
+#define COLOR_MODEL_BENCHMARK   0   /**< Замер стоимости преобразования моделей при старте */
+#endif
+#define COLOR_MODEL_BENCHMARK_CONVERSIONS   1000    /**< Преобразований на модель при замере */
+
+#ifndef OKLAB_BENCHMARK
+#define OKLAB_BENCHMARK     0       /**< Замер стоимости OKLab на кадр ленты при старте */
+#endif
+
+#ifndef BOOT_TIMING
+#define BOOT_TIMING         0       /**< Замер времени запуска до первого фронта PWM (DWT и BOOT_TIMING_PIN) */
+#endif
+
+#ifndef HAL_BENCHMARK
+#define HAL_BENCHMARK       0       /**< Замер стоимости HAL против прямых вызовов драйверов при старте */
+#endif
+#define HAL_BENCHMARK_CALLS 1000    /**< Вызовов на замер */
+
+#ifndef PIXEL_FRAME_BENCHMARK
+#define PIXEL_FRAME_BENCHMARK   0   /**< Замер пакетного HSV -> RGB при старте */
+#endif
+
+/* ---------------- Power limiter ---------------- */
+#ifndef POWER_LIMITER_ENABLED
+#define POWER_LIMITER_ENABLED   1       /**< Снижение тока светодиодов при нагреве кристалла */
+#endif
+
+#ifndef POWER_LIMITER_CHANNEL_UA
+#define POWER_LIMITER_CHANNEL_UA    10000   /**< Ток канала RGB при 100% скважности, мкА (оценка, уточнить измерением) */
+#endif
+
+#ifndef POWER_LIMITER_INDICATOR_UA
+#define POWER_LIMITER_INDICATOR_UA  5000    /**< Ток индикатора при 100% яркости, мкА (оценка, уточнить измерением) */
+#endif
+
+#define POWER_LIMITER_BUDGET_UA     35000   /**< Бюджет без нагрева: все каналы и индикатор на 100% */
+#define POWER_LIMITER_BUDGET_MIN_UA 12000   /**< Бюджет при POWER_LIMITER_TEMP_MAX_C и выше */
+#define POWER_LIMITER_TEMP_START_C  45      /**< Начало снижения бюджета */
+#define POWER_LIMITER_TEMP_MAX_C    70      /**< Бюджет снижен полностью */
+#define POWER_LIMITER_TEMP_PERIOD_MS 1000   /**< Интервал измерения температуры */
 
 /* ---------------- Timings ---------------- */
 #define MAIN_TIMER_INTERVAL_MS 20   /**< Интервал основного таймера в мс */
-#define DEBOUNCE_MS       200   /**< Время антидребезга в миллисекундах */
-#define DOUBLE_CLICK_MS   500   /**< Таймаут для обнаружения двойного клика */
 
-#define HOLD_INTERVAL_MS       MAIN_TIMER_INTERVAL_MS   /**< Интервал изменения при удержании кнопки */
-#define HUE_HOLD_STEP          1    /**< Шаг изменения оттенка при удержании */
-#define SAT_VAL_HOLD_STEP      1    /**< Шаг изменения насыщенности и яркости при удержании */
+#define DEEP_SLEEP_IDLE_TIMEOUT_MS  60000   /**< Бездействие с нулевой яркостью до перехода в System OFF */
 
-#define SLOW_BLINK_PERIOD_MS   1500 /**< Период медленного мигания в мс */  
-#define FAST_BLINK_PERIOD_MS   500  /**< Период быстрого мигания в мс */
+#define COLOR_FADE_MS          400  /**< Плавное включение сохранённого цвета после System OFF */
+#define LFCLK_MIGRATE_DELAY_MS 1000 /**< Переход LFRC -> LFXO после запуска, когда плавное включение закончилось */
 
 /* ---------------- Forward decl ---------------- */
-void pwm_init(void);
+void leds_init(void);
 void button_init(void);
 void main_timer_handler(void * p_context);
-void debounce_timer_handler(void * p_context);
-void double_click_timer_handler(void * p_context);
-void button_press_handler(nrfx_gpiote_pin_t pin, nrf_gpiote_polarity_t action);
-static void update_indicator_for_current_mode(void);
-static inline int clamp_value(int value, int min, int max);
-static void convert_hsv_to_rgb(float hue, int saturation, int value, uint16_t *red, uint16_t *green, uint16_t *blue);
-static void update_pwm_outputs(uint16_t indicator, uint16_t red, uint16_t green, uint16_t blue);
+void lfclk_migrate_timer_handler(void * p_context);
+void button_press_handler(void);
+static bool app_shutdown_handler(nrf_pwr_mgmt_evt_t event);
+
 
+#if WS2812_ENABLED || PIXEL_FRAME_BENCHMARK
+static pixel_frame_t m_frame;   /**< Кадр пикселей в раскладке SoA */
+#endif
 
-static nrfx_pwm_t m_pwm_instance = NRFX_PWM_INSTANCE(0);    /**< Экземпляр PWM */
-static nrf_pwm_values_individual_t m_pwm_channel_values;    /**< Значения для каналов PWM */
+#if WS2812_ENABLED
+STATIC_ASSERT(WS2812_PIXEL_COUNT <= PIXEL_FRAME_PIXELS_MAX, "Strip does not fit into the pixel frame");
+static ws2812_pixel_t m_strip[WS2812_PIXEL_COUNT];  /**< Кадр адресной ленты */
+#endif
 
+#if POWER_LIMITER_ENABLED
 /**
- * @brief Режимы ввода устройства
+ * @brief Бюджет тока светодиодов (температура в единицах TEMP, 0.25 °C)
  */
-typedef enum {
-    MODE_NO_INPUT = 0,  /**< Режим без ввода */
-    MODE_HUE,           /**< Режим изменения оттенка */
-    MODE_SATURATION,    /**< Режим изменения насыщенности */
-    MODE_VALUE          /**< Режим изменения яркости */
-} input_mode_t;
-
-
-static volatile input_mode_t m_current_mode = MODE_NO_INPUT;    /**< Текущий режим работы */
-
-static float m_current_hue = 0.0f;  /**< Текущий оттенок (0-360 градусов) */    
-static int   m_current_saturation = 100;    /**< Текущая насыщенность (0-100%) */     
-static int   m_current_value = 100; /**< Текущая яркость (0-100%) */    
+static const power_limiter_config_t m_limiter_config = {
+    .channel_ua = { POWER_LIMITER_CHANNEL_UA, POWER_LIMITER_CHANNEL_UA, POWER_LIMITER_CHANNEL_UA },
+    .indicator_ua = POWER_LIMITER_INDICATOR_UA,
+    .budget_ua = POWER_LIMITER_BUDGET_UA,
+    .budget_min_ua = POWER_LIMITER_BUDGET_MIN_UA,
+    .temp_start = POWER_LIMITER_TEMP_START_C * 4,
+    .temp_max = POWER_LIMITER_TEMP_MAX_C * 4
+};
+
+static uint32_t m_temp_elapsed_ms = 0;  /**< Время с прошлого запуска измерения температуры */
+#endif
 
-static int m_hue_direction = 1; /**< Направление изменения оттенка */
-static int m_saturation_direction = 1;  /**< Направление изменения насыщенности */
-static int m_value_direction = 1;   /**< Направление изменения яркости */
-
-static int m_indicator_brightness = 0;  /**< Текущая яркость индикатора */
-static int m_indicator_direction = 1;   /**< Направление изменения яркости индикатора */
+/**
+ * @brief Параметры логики приложения
+ */
+static const app_logic_config_t m_logic_config = {
+    .button_pin = BOARD_PIN_BUTTON,
+    .color_model = COLOR_MODEL,
+    .tick_ms = MAIN_TIMER_INTERVAL_MS,
+    .idle_timeout_ms = DEEP_SLEEP_IDLE_TIMEOUT_MS,
+#if POWER_LIMITER_ENABLED
+    .p_limiter = &m_limiter_config
+#else
+    .p_limiter = NULL
+#endif
+};
+
+#if OKLAB_BENCHMARK
+static volatile oklab_benchmark_t m_oklab_benchmark;    /**< Результат замера (для отладчика) */
+#endif
+
+#if COLOR_MODEL_BENCHMARK
+static volatile color_model_benchmark_t m_color_benchmarks[COLOR_MODEL_COUNT];  /**< Результаты замера (для отладчика) */
+#endif
+
+#if BOOT_TIMING
+static volatile boot_timing_t m_boot_timing;    /**< Время запуска (для отладчика) */
+#endif
+
+#if HAL_BENCHMARK
+static volatile hal_nrf_benchmark_t m_hal_benchmark;    /**< Результат замера (для отладчика) */
+#endif
+
+#if PIXEL_FRAME_BENCHMARK
+static volatile pixel_frame_benchmark_t m_frame_benchmark;   /**< Результат замера (для отладчика) */
+#endif
+
+STATIC_ASSERT(sizeof(app_state_t) <= WDT_SUPERVISOR_SNAPSHOT_SIZE, "State snapshot does not fit into .noinit");
+
+static wdt_supervisor_task_t m_wdt_task_tick;   /**< Основной таймер */
+static wdt_supervisor_task_t m_wdt_task_input;  /**< Обработка кнопки */
+static wdt_supervisor_task_t m_wdt_task_main;   /**< Основной цикл (USB, выключение) */
+
+static volatile wdt_supervisor_report_t m_reset_report;    /**< Причина предыдущего сброса (для отладчика) */
+static volatile app_state_t m_reset_state;  /**< Состояние на последнем тике перед сбросом (для отладчика) */
+
+/* Режим пишет обработчик кнопки, цвет и индикатор - основной таймер: публикации не должны прерывать друг друга */
+STATIC_ASSERT(NRFX_GPIOTE_CONFIG_IRQ_PRIORITY == APP_TIMER_CONFIG_IRQ_PRIORITY,
+              "app_state writers must run at the same priority");
+
+#if AMBIENT_ENABLED
+static ambient_filter_t m_ambient_filter;   /**< Сглаживание освещённости */
+#endif
+
+static volatile bool m_shutdown_pending = false;    /**< Кнопка отпущена, можно выключаться */
+static uint32_t m_input_presses = 0;    /**< Вызовы обработчика нажатия (пишет только он) */
+static uint32_t m_input_presses_seen = 0;   /**< То же на прошлом тике */
+static bool m_input_released = false;   /**< Кнопка была отпущена после последнего нажатия */
 
+/**
+ * @brief Цвет, сохраняемый на время System OFF
+ */
+typedef struct {
+    float hue;
+    int   saturation;
+    int   value;
+} retained_color_t;
 
-static volatile bool m_button_blocked = false;  /**< Флаг блокировки кнопки (антидребезг) */
-static volatile bool m_first_click_detected = false;    /**< Флаг обнаружения первого клика */
-static volatile bool m_button_hold = false; /**< Флаг удержания кнопки */
+NRF_PWR_MGMT_HANDLER_REGISTER(app_shutdown_handler, 0);
 
-APP_TIMER_DEF(main_timer);  /**< Таймер основного цикла */
-APP_TIMER_DEF(debounce_timer);  /**< Таймер антидребезга */
-APP_TIMER_DEF(double_click_timer);  /**< Таймер двойного клика */
+HAL_TIMER_DEF(main_timer);  /**< Таймер основного цикла */
+HAL_TIMER_DEF(lfclk_migrate_timer); /**< Таймер перехода на LFXO */
 
+/**
+ * @brief Размещение светодиодов на каналах PWM
+ */
+void leds_init(void) {
+    static const hal_output_pins_t pins = BOARD_OUTPUT_PINS;
 
-static uint32_t m_indicator_step = 1;   /**< Шаг изменения индикатора */
+    APP_ERROR_CHECK(hal_output_init(&pins));
 
-static uint32_t m_indicator_period_ms = SLOW_BLINK_PERIOD_MS;   /**< Период мигания индикатора */
+#if WS2812_ENABLED
+    APP_ERROR_CHECK(ws2812_init(BOARD_PIN_WS2812, WS2812_TYPE, WS2812_PIXEL_COUNT));
+#endif
+}
 
 /**
-* @brief Вспомогательная функция: ограничение целого значения в диапазоне.
-* @param v значение
-* @param min нижняя граница
-* @param max верхняя граница
-* @return ограниченное значение
-*/
-static inline int clamp_value(int value, int min, int max) {
-    if (value < min) return min;
-    if (value > max) return max;
-    return value;
+ * @brief Инициализация кнопки
+ */
+void button_init(void) {
+    hal_input_init(BOARD_PIN_BUTTON, button_press_handler);
 }
 
 /**
- * @brief Конвертирует цвет из HSV в RGB пространство
- * @param hue Оттенок (0-360 градусов)
- * @param saturation Насыщенность (0-100%)
- * @param value Яркость (0-100%)
- * @param red Указатель для красной компоненты
- * @param green Указатель для зеленой компоненты
- * @param blue Указатель для синей компоненты
+ * @brief Обработчик таймера перехода на LFXO
  */
-static void convert_hsv_to_rgb(float hue, int saturation, int value, uint16_t *red, uint16_t *green, uint16_t *blue) {
-    float hue_normalized = hue;
-    float saturation_normalized = saturation / 100.0f;
-    float value_normalized = value / 100.0f;
-
-    // Если насыщенность нулевая - оттенки серого
-    if (saturation_normalized <= 0.0f) {
-        uint16_t gray_value = (uint16_t)(value_normalized * DUTY_MAX + 0.5f);
-        *red = *green = *blue = gray_value;
-        return;
-    }
-
-    // Нормализация оттенка
-    if (hue_normalized >= 360.0f) hue_normalized = 0.0f;
-    float hue_sector = hue_normalized / 60.0f;
-    int sector_index = (int)floorf(hue_sector);
-    float fractional = hue_sector - sector_index;
-    
-    // Промежуточные значения
-    float p = value_normalized * (1.0f - saturation_normalized);
-    float q = value_normalized * (1.0f - saturation_normalized * fractional);
-    float t = value_normalized * (1.0f - saturation_normalized * (1.0f - fractional));
-
-    float red_float = 0, green_float = 0, blue_float = 0;
-    
-    // Выбор сектора цветового круга
-    switch (sector_index) {
-        case 0: red_float = value_normalized; green_float = t; blue_float = p; break;
-        case 1: red_float = q; green_float = value_normalized; blue_float = p; break;
-        case 2: red_float = p; green_float = value_normalized; blue_float = t; break;
-        case 3: red_float = p; green_float = q; blue_float = value_normalized; break;
-        case 4: red_float = t; green_float = p; blue_float = value_normalized; break;
-        default: red_float = value_normalized; green_float = p; blue_float = q; break;
-    }
+void lfclk_migrate_timer_handler(void *p_context) {
+    (void)p_context;
+    power_profile_lfclk_migrate();
 
-    // Конвертация в PWM значения
-    *red = (uint16_t)clamp_value((int)roundf(red_float * DUTY_MAX), 0, DUTY_MAX);
-    *green = (uint16_t)clamp_value((int)roundf(green_float * DUTY_MAX), 0, DUTY_MAX);
-    *blue = (uint16_t)clamp_value((int)roundf(blue_float * DUTY_MAX), 0, DUTY_MAX);
+    // LFCLK запрошен от источника профиля, его больше не останавливают. Пока LFXO
+    // запускается, WDT сам держит LFRC; кормление стоит вместе с RTC1, но ~0,25 с
+    // меньше WDT_SUPERVISOR_RELOAD_MS
+    wdt_supervisor_start();
 }
 
 /**
- * @brief Обновляет выходы PWM
- * @param indicator Яркость индикаторного светодиода
- * @param red Яркость красного канала
- * @param green Яркость зеленого канала
- * @param blue Яркость синего канала
+ * @brief Обработчик нажатия кнопки
  */
-static void update_pwm_outputs(uint16_t indicator, uint16_t red, uint16_t green, uint16_t blue) {
-    m_pwm_channel_values.channel_0 = indicator;
-    m_pwm_channel_values.channel_1 = red;
-    m_pwm_channel_values.channel_2 = green;
-    m_pwm_channel_values.channel_3 = blue;
-
-    nrf_pwm_sequence_t sequence = {
-        .values.p_individual = &m_pwm_channel_values,
-        .length = PWM_CHANNELS,
-        .repeats = 0,
-        .end_delay = 0
-    };
+void button_press_handler(void) {
+    mem_monitor_isr_mark();
+    power_monitor_cause_t prev_cause = power_monitor_enter(POWER_MONITOR_CAUSE_GPIOTE);
+
+    m_input_presses++;
+    app_logic_press();
 
-    nrfx_pwm_simple_playback(&m_pwm_instance, &sequence, 1, 0);
+    power_monitor_exit(prev_cause);
 }
 
+#if POWER_LIMITER_ENABLED
 /**
- * @brief Обновляет параметры индикатора для текущего режима
+ * @brief Температура кристалла для ограничителя тока без ожидания
+ *
+ * Измерение (~36 мкс) запускается раз в POWER_LIMITER_TEMP_PERIOD_MS,
+ * результат забирается на следующем тике.
  */
-static void update_indicator_for_current_mode(void) {
-    switch (m_current_mode) {
-        case MODE_NO_INPUT:
-            m_indicator_period_ms = 0; // Индикатор выключен
-            break;
-        case MODE_HUE:
-            m_indicator_period_ms = SLOW_BLINK_PERIOD_MS; // Медленное мигание
-            break;
-        case MODE_SATURATION:
-            m_indicator_period_ms = FAST_BLINK_PERIOD_MS; // Быстрое мигание
-            break;
-        case MODE_VALUE:
-            m_indicator_period_ms = 1; // Постоянно включен
-            break;
+static void die_temperature_poll(void) {
+    if (NRF_TEMP->EVENTS_DATARDY) {
+        NRF_TEMP->EVENTS_DATARDY = 0;
+        app_logic_temperature_set((int32_t)NRF_TEMP->TEMP);
+        NRF_TEMP->TASKS_STOP = 1;
     }
-    
-    // Расчет шага изменения индикатора
-    if (m_indicator_period_ms > 0) {
-        // Половина периода на нарастание яркости
-        m_indicator_step = (int)ceilf((float)DUTY_MAX * 
-                         ((float)MAIN_TIMER_INTERVAL_MS / (m_indicator_period_ms / 2.0f)));
-    } else {
-        m_indicator_step = DUTY_MAX;
+
+    m_temp_elapsed_ms += MAIN_TIMER_INTERVAL_MS;
+    if (m_temp_elapsed_ms >= POWER_LIMITER_TEMP_PERIOD_MS) {
+        m_temp_elapsed_ms = 0;
+        NRF_TEMP->TASKS_START = 1;
     }
-    
-    if (m_indicator_step < 1) m_indicator_step = 1;
 }
+#endif
 
 /**
- * @brief Инициализация PWM
+ * @brief Обработчик основного таймера
  */
-void pwm_init(void) {
-    nrfx_pwm_config_t pwm_config = NRFX_PWM_DEFAULT_CONFIG;
-    pwm_config.output_pins[0] = INDICATOR_LED_PIN;   // LED1 - индикатор
-    pwm_config.output_pins[1] = LED_RED;     // LED2 - красный
-    pwm_config.output_pins[2] = LED_GREEN;   // LED2 - зеленый
-    pwm_config.output_pins[3] = LED_BLUE;    // LED2 - синий
-    pwm_config.base_clock = NRF_PWM_CLK_1MHz;
-    pwm_config.count_mode = NRF_PWM_MODE_UP;
-    pwm_config.top_value  = DUTY_MAX;
-    pwm_config.load_mode  = NRF_PWM_LOAD_INDIVIDUAL;
-    pwm_config.step_mode  = NRF_PWM_STEP_AUTO;
-
-    nrfx_pwm_init(&m_pwm_instance, &pwm_config, NULL);
-
-    // Инициализация значений каналов
-    m_pwm_channel_values.channel_0 = 0;
-    m_pwm_channel_values.channel_1 = 0;
-    m_pwm_channel_values.channel_2 = 0;
-    m_pwm_channel_values.channel_3 = 0;
+void main_timer_handler(void *p_context) {
+    (void)p_context;
 
-    // Создание и запуск основного таймера
-    app_timer_create(&main_timer, APP_TIMER_MODE_REPEATED, main_timer_handler);
-    app_timer_start(main_timer, APP_TIMER_TICKS(MAIN_TIMER_INTERVAL_MS), NULL);
-}
+    mem_monitor_isr_mark();
+    power_monitor_cause_t prev_cause = power_monitor_enter(POWER_MONITOR_CAUSE_TIMER);
 
-/**
- * @brief Инициализация кнопки
- */
-void button_init(void) {
-    if (!nrfx_gpiote_is_init()) {
-        nrfx_gpiote_init();
+    // Ввод жив, если нажатие после отпускания дошло до обработчика. Кнопка, нажатая
+    // без вызова обработчика, - зависший GPIOTE; фронт, ждущий своей очереди на
+    // этом же приоритете, задерживает отметку лишь на тик. Удержание с выхода из
+    // System OFF (нажатие было до запуска GPIOTE) не считается: отпускания ещё не было
+    if (m_input_presses != m_input_presses_seen) {
+        m_input_presses_seen = m_input_presses;
+        m_input_released = false;
+    }
+    bool pressed = hal_input_pressed(BOARD_PIN_BUTTON);
+    if (!pressed) {
+        m_input_released = true;
+    }
+    if (!(pressed && m_input_released)) {
+        wdt_supervisor_checkin(m_wdt_task_input);
     }
 
-    // Настройка пина кнопки
-    nrf_gpio_cfg_input(BUTTON_PIN, NRF_GPIO_PIN_PULLUP);
+#if AMBIENT_ENABLED
+    // Датчик опрашивается без CPU, сглаживание - на тике: множитель меняется без ступенек
+    app_logic_gain_set(ambient_filter_update(&m_ambient_filter, ambient_level_get()));
+#endif
 
-    // Конфигурация GPIOTE для кнопки
-    nrfx_gpiote_in_config_t input_config = NRFX_GPIOTE_CONFIG_IN_SENSE_HITOLO(true);
-    input_config.pull = NRF_GPIO_PIN_PULLUP;
+#if POWER_LIMITER_ENABLED
+    die_temperature_poll();
+#endif
 
-    nrfx_gpiote_in_init(BUTTON_PIN, &input_config, button_press_handler);
-    nrfx_gpiote_in_event_enable(BUTTON_PIN, true);
+    // Удержание, анимация и вывод кадра
+    app_state_t state;
+    if (app_logic_tick(&state)) {
+        m_shutdown_pending = true;
+    }
 
-    // Создание таймеров для обработки кнопки
-    app_timer_create(&debounce_timer, APP_TIMER_MODE_SINGLE_SHOT, debounce_timer_handler);
-    app_timer_create(&double_click_timer, APP_TIMER_MODE_SINGLE_SHOT, double_click_timer_handler);
-}
+#if WS2812_ENABLED
+    // Лента показывает тот же цвет (с разбросом оттенка), преобразование - пакетом
+    uint32_t strip_hue = (uint32_t)(state.hue * PIXEL_FRAME_HUE_MAX / 360.0f);
+    uint16_t strip_saturation = (uint16_t)(state.saturation * PIXEL_FRAME_LEVEL_MAX / 100);
+    uint16_t strip_value = (uint16_t)(state.value * PIXEL_FRAME_LEVEL_MAX / 100);
+    m_frame.count = WS2812_PIXEL_COUNT;
+    for (int i = 0; i < WS2812_PIXEL_COUNT; i++) {
+        m_frame.hue[i] = (uint16_t)((strip_hue + (uint32_t)i * WS2812_HUE_SPREAD / WS2812_PIXEL_COUNT)
+                                    % PIXEL_FRAME_HUE_MAX);
+        m_frame.saturation[i] = strip_saturation;
+        m_frame.value[i] = strip_value;
+    }
+    pixel_frame_hsv_to_rgb(&m_frame);
+    for (int i = 0; i < WS2812_PIXEL_COUNT; i++) {
+        m_strip[i].r = (uint8_t)m_frame.red[i];
+        m_strip[i].g = (uint8_t)m_frame.green[i];
+        m_strip[i].b = (uint8_t)m_frame.blue[i];
+        m_strip[i].w = 0;
+    }
+    ws2812_show(m_strip);
+#endif
 
-/**
- * @brief Обработчик таймера антидребезга
- */
-void debounce_timer_handler(void *p_context) {
-    (void)p_context;
-    m_button_blocked = false;
-}
+    // Снимок для разбора после сброса; стоимость - копия ~20 байт
+    wdt_supervisor_snapshot(&state, sizeof(state));
+    wdt_supervisor_checkin(m_wdt_task_tick);
 
-/**
- * @brief Обработчик таймера двойного клика
- */
-void double_click_timer_handler(void *p_context) {
-    (void)p_context;
-    m_first_click_detected = false;
+    power_monitor_exit(prev_cause);
 }
 
 /**
- * @brief Обработчик нажатия кнопки
+ * @brief Подготовка к System OFF: гашение светодиодов и сохранение цвета
+ * @param event Событие nrf_pwr_mgmt
+ * @return true - модуль готов к выключению
  */
-void button_press_handler(nrfx_gpiote_pin_t pin, nrf_gpiote_polarity_t action) {
-    (void)pin; 
-    (void)action;
+static bool app_shutdown_handler(nrf_pwr_mgmt_evt_t event) {
+    if (event != NRF_PWR_MGMT_EVT_PREPARE_SYSOFF) {
+        return true;
+    }
 
-    // Пропуск если кнопка заблокирована (антидребезг)
-    if (m_button_blocked) return;
+    hal_timer_stop(main_timer);
+    hal_input_uninit(BOARD_PIN_BUTTON);
 
-    m_button_blocked = true;
-    app_timer_start(debounce_timer, APP_TIMER_TICKS(DEBOUNCE_MS), NULL);
+    hal_output_uninit();
 
-    // Обработка одиночного/двойного клика
-    if (!m_first_click_detected) {
-        m_first_click_detected = true;
-        app_timer_start(double_click_timer, APP_TIMER_TICKS(DOUBLE_CLICK_MS), NULL);
-    } else {
-        m_first_click_detected = false;
-        app_timer_stop(double_click_timer);
+#if AMBIENT_ENABLED
+    ambient_uninit();
+#endif
 
-        // Циклическое переключение режимов
-         m_current_mode = (m_current_mode + 1) % 4;
+#if USB_CLI_ENABLED
+    usb_cli_uninit();
+#endif
 
-        // Сброс направлений изменения
-        m_hue_direction = 1;
-        m_saturation_direction = 1;
-        m_value_direction = 1;
-
-        update_indicator_for_current_mode();
+#if WS2812_ENABLED
+    // Лента держит последний кадр - гасим её перед выключением
+    memset(m_strip, 0, sizeof(m_strip));
+    ws2812_show(m_strip);
+    while (ws2812_is_busy()) {
     }
+    ws2812_uninit();
+#endif
+
+    app_state_t state;
+    app_state_read(&state);
 
-    m_button_hold = true;
+    retained_color_t color = {
+        .hue = state.hue,
+        .saturation = state.saturation,
+        .value = state.value
+    };
+    system_off_prepare(&color, sizeof(color), BOARD_PIN_BUTTON);
+
+    return true;
 }
 
 /**
- * @brief Обработчик основного таймера
+ * @brief Основная функция программы
  */
-void main_timer_handler(void *p_context) {
-    (void)p_context;
-
-    // Проверка отпускания кнопки
-    if (m_button_hold) {
-        if (nrf_gpio_pin_read(BUTTON_PIN) != 0) {
-            m_button_hold = false;
-        }
+int main(void) {
+#if BOOT_TIMING
+    boot_timing_start();
+#endif
+
+    // Разметка стека для контроля его глубины
+    mem_monitor_init();
+
+    // Причина сброса (до system_off_restore); WDT запускается после перехода LFCLK на LFXO
+    wdt_supervisor_init();
+    wdt_supervisor_report_get((wdt_supervisor_report_t *)&m_reset_report);
+    if (m_reset_report.snapshot_valid) {
+        app_state_t reset_state;
+        memcpy(&reset_state, (void const *)m_reset_report.snapshot, sizeof(reset_state));
+        m_reset_state = reset_state;
     }
 
-    // Обработка удержания кнопки в активных режимах
-    if (m_button_hold && m_current_mode != MODE_NO_INPUT) {
-        switch (m_current_mode) {
-            case MODE_HUE:
-                m_current_hue += m_hue_direction * HUE_HOLD_STEP;
-                if (m_current_hue >= 360.0f) {
-                    m_current_hue = 360.0f;
-                    m_hue_direction = -1;
-                } else if (m_current_hue <= 0.0f) {
-                    m_current_hue = 0.0f;
-                    m_hue_direction = 1;
-                }
-                break;
-                
-            case MODE_SATURATION:
-                m_current_saturation += m_saturation_direction * SAT_VAL_HOLD_STEP;
-                if (m_current_saturation >= 100) {
-                    m_current_saturation = 100;
-                    m_saturation_direction = -1;
-                } else if (m_current_saturation <= 0) {
-                    m_current_saturation = 0;
-                    m_saturation_direction = 1;
-                }
-                break;
-                
-            case MODE_VALUE:
-                m_current_value += m_value_direction * SAT_VAL_HOLD_STEP;
-                if (m_current_value >= 100) {
-                    m_current_value = 100;
-                    m_value_direction = -1;
-                } else if (m_current_value <= 0) {
-                    m_current_value = 0;
-                    m_value_direction = 1;
-                }
-                break;
-                
-            default:
-                break;
-        }
+    // DC/DC и запуск LFCLK от LFRC (без ожидания), LFXO подключается позже
+    power_profile_init(POWER_PROFILE);
+#if BOOT_TIMING
+    boot_timing_mark(BOOT_TIMING_CLOCKS);
+#endif
+
+    // Установка начальных значений HSV или цвета, сохранённого перед System OFF
+    app_state_t state = { .mode = MODE_NO_INPUT };
+    retained_color_t color;
+    uint32_t fade_in_ms = 0;
+    if (system_off_restore(&color, sizeof(color))) {
+        state.hue = color.hue;
+        state.saturation = color.saturation;
+        state.value = color.value;
+
+        // Сохранённый цвет виден с первого кадра: половина яркости, затем плавно до полной
+        fade_in_ms = COLOR_FADE_MS;
+    } else {
+        state.saturation = 100;
+        state.value = 100;
+        state.hue = (1.0f / 100.0f) * 360.0f; // 1% от 360° = 3.6°
     }
 
-    // Обновление индикатора
-    uint16_t indicator_brightness = 0;
-    if (m_current_mode == MODE_NO_INPUT) {
-        indicator_brightness = 0;
-        m_indicator_brightness = 0;
-    } else if (m_current_mode == MODE_VALUE) {
-        indicator_brightness = DUTY_MAX;
-        m_indicator_brightness = DUTY_MAX;
-    } else {
-        if (m_indicator_period_ms > 0) {
-            m_indicator_brightness += (int)m_indicator_step * m_indicator_direction;
-            if (m_indicator_brightness >= (int)DUTY_MAX) {
-                m_indicator_brightness = DUTY_MAX;
-                m_indicator_direction = -1;
-            } else if (m_indicator_brightness <= 0) {
-                m_indicator_brightness = 0;
-                m_indicator_direction = 1;
-            }
-            indicator_brightness = (uint16_t)clamp_value(m_indicator_brightness, 0, DUTY_MAX);
-        } else {
-            indicator_brightness = 0;
-        }
+    // Калибровка цвета этого экземпляра платы (из flash)
+    color_calib_init();
+
+    // Цвет включается до запуска LFCLK: PWM тактируется от HFCLK
+    leds_init();
+    app_logic_init(&m_logic_config, &state, fade_in_ms);
+#if BOOT_TIMING
+    boot_timing_mark(BOOT_TIMING_FIRST_LIGHT);
+#endif
+
+#if COLOR_MODEL_BENCHMARK
+    for (int i = 0; i < COLOR_MODEL_COUNT; i++) {
+        color_model_benchmark((color_model_t)i, COLOR_MODEL_BENCHMARK_CONVERSIONS,
+                              (color_model_benchmark_t *)&m_color_benchmarks[i]);
     }
+#endif
 
-    // Обновление цвета RGB светодиода
-    uint16_t red, green, blue;
-    convert_hsv_to_rgb(m_current_hue, m_current_saturation, m_current_value, &red, &green, &blue);
-    update_pwm_outputs(indicator_brightness, red, green, blue);
-}
+#if OKLAB_BENCHMARK
+    oklab_benchmark(WS2812_PIXEL_COUNT, MAIN_TIMER_INTERVAL_MS * 1000, (oklab_benchmark_t *)&m_oklab_benchmark);
+#endif
 
-/**
- * @brief Основная функция программы
- */
-int main(void) {
-    // Инициализация тактирования
-    nrfx_clock_init(NULL);
-    nrfx_clock_lfclk_start();
+#if PIXEL_FRAME_BENCHMARK
+    pixel_frame_benchmark(&m_frame, PIXEL_FRAME_PIXELS_MAX, (pixel_frame_benchmark_t *)&m_frame_benchmark);
+#endif
+
+    // Ожидание LFCLK (LFRC)
     while(!nrfx_clock_lfclk_is_running());
+#if BOOT_TIMING
+    boot_timing_mark(BOOT_TIMING_LFCLK);
+    boot_timing_get((boot_timing_t *)&m_boot_timing);
+#endif
 
     // Инициализация таймеров
     app_timer_init();
 
-    // Установка начальных значений HSV
-    m_current_saturation = 100;
-    m_current_value = 100;
-    m_current_hue = (1.0f / 100.0f) * 360.0f; // 1% от 360° = 3.6°
+    // Управление питанием и учёт времени сна
+    nrf_pwr_mgmt_init();
+    power_monitor_init();
 
-    // Настройка индикатора для текущего режима
-    update_indicator_for_current_mode();
+#if HAL_BENCHMARK
+    // Замер запускает PWM (учёт power_monitor уже работает); светодиоды гаснут до первого тика
+    hal_nrf_benchmark(BOARD_PIN_BUTTON, HAL_BENCHMARK_CALLS, (hal_nrf_benchmark_t *)&m_hal_benchmark);
+#endif
 
-    // Инициализация периферии
-    pwm_init();
+    // Инициализация кнопки
     button_init();
 
-    // Установка начального цвета
-    uint16_t red, green, blue;
-    convert_hsv_to_rgb(m_current_hue, m_current_saturation, m_current_value, &red, &green, &blue);
-    update_pwm_outputs(0, red, green, blue);
+#if AMBIENT_ENABLED
+    // Опрос датчика освещённости от RTC2 (нужен LFCLK)
+    ambient_filter_init(&m_ambient_filter);
+    APP_ERROR_CHECK(ambient_init(BOARD_PIN_AIN(BOARD_PIN_AMBIENT)));
+#endif
+
+#if USB_CLI_ENABLED
+    // Команды калибровки через USB CDC ACM
+    usb_cli_init();
+#endif
+
+    // WDT кормится, только когда отметились все задачи
+    APP_ERROR_CHECK(wdt_supervisor_task_add(&m_wdt_task_tick));
+    APP_ERROR_CHECK(wdt_supervisor_task_add(&m_wdt_task_input));
+    APP_ERROR_CHECK(wdt_supervisor_task_add(&m_wdt_task_main));
+
+    // Создание и запуск основного таймера
+    hal_timer_create(&main_timer, true, main_timer_handler);
+    hal_timer_start(main_timer, MAIN_TIMER_INTERVAL_MS, NULL);
+
+    // Переход на LFXO останавливает LFCLK: RTC, app_timer и hal_clock_ms() стоят ~0,25 с
+    // до запуска кварца, PWM держит текущий цвет. До перехода WDT не работает: он не
+    // дал бы остановить LFCLK, и запуск остаётся без защиты на LFCLK_MIGRATE_DELAY_MS
+    if (power_profile_lfclk_migrate_pending()) {
+        hal_timer_create(&lfclk_migrate_timer, false, lfclk_migrate_timer_handler);
+        hal_timer_start(lfclk_migrate_timer, LFCLK_MIGRATE_DELAY_MS, NULL);
+    } else {
+        wdt_supervisor_start();
+    }
 
     // Основной цикл
     while (1) {
-        __WFE();
+#if USB_CLI_ENABLED
+        while (usb_cli_process()) {
+        }
+#endif
+        // Основной цикл просыпается хотя бы на каждом тике
+        wdt_supervisor_checkin(m_wdt_task_main);
+
+        power_monitor_idle();
+
+        if (m_shutdown_pending) {
+            nrf_pwr_mgmt_shutdown(NRF_PWR_MGMT_SHUTDOWN_GOTO_SYSOFF);
+        }
     }
 }
@@ -0,0 +1,89 @@
+#include <malloc.h>
+#include "nrf.h"
+#include "sdk_config.h"
+#include "app_error.h"
+#include "mem_monitor.h"
+
+#if NRF_STACK_GUARD_ENABLED
+#include "nrf_stack_guard.h"
+#define MEM_MONITOR_GUARD_SIZE  STACK_GUARD_SIZE
+#else
+#define MEM_MONITOR_GUARD_SIZE  0
+#endif
+
+#define STACK_PAINT_PATTERN     0xDEADBEEFUL    /**< Шаблон заполнения свободного стека */
+
+/* Символы из nrf_common.ld */
+extern uint32_t __StackLimit;
+extern uint32_t __StackTop;
+extern uint32_t __HeapBase;
+extern uint32_t __HeapLimit;
+
+static uint32_t m_thread_sp;            /**< SP основного цикла (база для глубины ISR) */
+static volatile uint32_t m_isr_min_sp;  /**< Наименьший SP, замеченный в обработчиках */
+
+/**
+ * @brief Нижняя граница доступной части стека
+ */
+static inline uint32_t * stack_bottom(void) {
+    return (uint32_t *)((uint32_t)&__StackLimit + MEM_MONITOR_GUARD_SIZE);
+}
+
+/**
+ * @brief Заполнение стека шаблоном от нижней границы до текущего SP
+ */
+static void __attribute__((noinline)) stack_paint(void) {
+    volatile uint32_t * p_word = stack_bottom();
+    uint32_t * p_sp = (uint32_t *)__get_MSP();
+
+    while (p_word < p_sp) {
+        *p_word++ = STACK_PAINT_PATTERN;
+    }
+}
+
+void mem_monitor_init(void) {
+    m_thread_sp = __get_MSP();
+    m_isr_min_sp = m_thread_sp;
+
+    stack_paint();
+
+#if NRF_STACK_GUARD_ENABLED
+    APP_ERROR_CHECK(nrf_stack_guard_init());
+#endif
+}
+
+void mem_monitor_isr_mark(void) {
+    uint32_t sp = __get_MSP();
+
+    if (sp < m_isr_min_sp) {
+        m_isr_min_sp = sp;
+    }
+}
+
+uint32_t mem_monitor_stack_size(void) {
+    return (uint32_t)&__StackTop - (uint32_t)stack_bottom();
+}
+
+uint32_t mem_monitor_stack_high_watermark(void) {
+    uint32_t const * p_word = stack_bottom();
+    uint32_t const * p_top = (uint32_t const *)&__StackTop;
+
+    while (p_word < p_top && *p_word == STACK_PAINT_PATTERN) {
+        p_word++;
+    }
+
+    return (uint32_t)p_top - (uint32_t)p_word;
+}
+
+uint32_t mem_monitor_isr_stack_high_watermark(void) {
+    return m_thread_sp - m_isr_min_sp;
+}
+
+void mem_monitor_heap_get(mem_monitor_heap_t * p_heap) {
+    struct mallinfo info = mallinfo();
+
+    p_heap->capacity = (uint32_t)&__HeapLimit - (uint32_t)&__HeapBase;
+    p_heap->arena    = (uint32_t)info.arena;
+    p_heap->in_use   = (uint32_t)info.uordblks;
+    p_heap->free     = (uint32_t)info.fordblks;
+}
@@ -0,0 +1,55 @@
+#ifndef MEM_MONITOR_H__
+#define MEM_MONITOR_H__
+
+#include <stdint.h>
+
+/**
+ * @brief Сведения об использовании кучи
+ */
+typedef struct {
+    uint32_t capacity;      /**< Размер региона кучи из скрипта линкера (__HEAP_SIZE) */
+    uint32_t arena;         /**< Объём, полученный malloc через sbrk: newlib nano не возвращает его, это пик кучи */
+    uint32_t in_use;        /**< Занято выделенными блоками */
+    uint32_t free;          /**< Свободно внутри арены */
+} mem_monitor_heap_t;
+
+/**
+ * @brief Заполняет свободную часть стека шаблоном и включает защиту стека.
+ *
+ * Вызывается первой строкой main(): всё, что ниже текущего SP, ещё не
+ * использовалось. Область NRF_STACK_GUARD не трогается - после включения
+ * защиты она недоступна для записи.
+ */
+void mem_monitor_init(void);
+
+/**
+ * @brief Отмечает глубину стека в обработчике прерывания.
+ *
+ * Все прерывания работают на том же стеке MSP, что и main(), поэтому
+ * глубина ISR считается от SP основного цикла. Значение - оценка снизу:
+ * учитывается только кадр вызвавшего обработчика.
+ */
+void mem_monitor_isr_mark(void);
+
+/**
+ * @brief Размер стека без области защиты
+ */
+uint32_t mem_monitor_stack_size(void);
+
+/**
+ * @brief Максимальная глубина стека с момента старта (по шаблону заполнения)
+ */
+uint32_t mem_monitor_stack_high_watermark(void);
+
+/**
+ * @brief Максимальная глубина стека, занятая обработчиками прерываний
+ */
+uint32_t mem_monitor_isr_stack_high_watermark(void);
+
+/**
+ * @brief Текущее использование кучи
+ * @param p_heap Структура для результата
+ */
+void mem_monitor_heap_get(mem_monitor_heap_t * p_heap);
+
+#endif // MEM_MONITOR_H__
@@ -0,0 +1,341 @@
+#include "nrf.h"
+#include "cycle_counter.h"
+#include "oklab.h"
+
+#define MATRIX_SHIFT    12      /**< Коэффициенты матриц в Q12 */
+#define CBRT_LUT_SHIFT  8       /**< Шаг таблицы кубического корня: 2^8 в Q15 */
+#define TRIG_LUT_SHIFT  8       /**< Шаг таблицы синуса: 2^8 двоичного угла */
+#define ATAN_LUT_BITS   5       /**< Таблица арктангенса: 2^5 шагов на 45° */
+#define OKLAB_LMS_LIMIT 39321   /**< Ограничение LMS' перед возведением в куб (1.2 в Q15) */
+#define OKLAB_ACHROMATIC 64     /**< Цветность, ниже которой оттенок не определён */
+#define OKLAB_BENCH_COLORS 64   /**< Цветов в замере */
+
+/* Матрицы Бьёрна Оттоссона (OKLab), Q12. Строки M1 и M4 в сумме дают 4096,
+ * строки a и b в M2 - ноль: белый остаётся белым, серый - ахроматическим */
+static const int16_t m_rgb_to_lms[3][3] = {
+    { 1688, 2197,  211 },
+    {  868, 2788,  440 },
+    {  362, 1154, 2580 },
+};
+static const int16_t m_lms_to_lab[3][3] = {
+    {  862,  3251,   -17 },
+    { 8102, -9948,  1846 },
+    {  106,  3206, -3312 },
+};
+static const int16_t m_lab_to_lms[3][3] = {
+    { 4096,  1623,   884 },
+    { 4096,  -432,  -262 },
+    { 4096,  -367, -5290 },
+};
+static const int16_t m_lms_to_rgb[3][3] = {
+    { 16698, -13548,   946 },
+    { -5196,  10690, -1398 },
+    {   -17,  -2881,  6994 },
+};
+
+/* cbrt(i / 128) в Q15, i = 0..128 */
+static const uint16_t m_cbrt_lut[129] = {
+        0,  6502,  8192,  9377, 10321, 11118, 11815, 12438, 13004, 13525, 14008, 14460, 14886,
+    15288, 15671, 16035, 16384, 16718, 17040, 17350, 17649, 17939, 18219, 18491, 18755, 19012,
+    19262, 19506, 19744, 19976, 20203, 20425, 20643, 20855, 21064, 21268, 21469, 21666, 21860,
+    22050, 22237, 22420, 22601, 22779, 22954, 23127, 23297, 23465, 23630, 23793, 23954, 24112,
+    24269, 24423, 24576, 24727, 24876, 25023, 25168, 25312, 25454, 25595, 25734, 25872, 26008,
+    26143, 26276, 26408, 26539, 26668, 26797, 26924, 27049, 27174, 27298, 27420, 27541, 27662,
+    27781, 27899, 28016, 28132, 28248, 28362, 28476, 28588, 28700, 28811, 28921, 29030, 29138,
+    29246, 29352, 29458, 29564, 29668, 29772, 29875, 29977, 30079, 30180, 30280, 30379, 30478,
+    30577, 30674, 30771, 30868, 30964, 31059, 31154, 31248, 31341, 31434, 31527, 31619, 31710,
+    31801, 31891, 31981, 32071, 32159, 32248, 32336, 32423, 32510, 32596, 32682, 32768,
+};
+
+/* sin(i / 64 * 90°) в Q15, i = 0..64 */
+static const int16_t m_sin_lut[65] = {
+        0,   804,  1608,  2410,  3212,  4011,  4808,  5602,  6393,  7179,  7962,  8739,  9512,
+    10278, 11039, 11793, 12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530, 18204, 18868,
+    19519, 20159, 20787, 21403, 22005, 22594, 23170, 23731, 24279, 24811, 25329, 25832, 26319,
+    26790, 27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956, 30273, 30571, 30852, 31113,
+    31356, 31580, 31785, 31971, 32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757, 32767,
+};
+
+/* atan(i / 32), двоичный угол, i = 0..32 */
+static const uint16_t m_atan_lut[33] = {
+       0,  326,  651,  975, 1297, 1617, 1933, 2246, 2555, 2860, 3159, 3453, 3742, 4025, 4302, 4572,
+    4836, 5094, 5344, 5589, 5826, 6058, 6282, 6500, 6712, 6917, 7117, 7310, 7498, 7679, 7856, 8026,
+    8192,
+};
+
+/**
+ * @brief Умножение вектора Q15 на матрицу Q12
+ */
+static inline void matrix_apply(int16_t const m[3][3], int32_t const in[3], int32_t out[3]) {
+    for (int i = 0; i < 3; i++) {
+        out[i] = (m[i][0] * in[0] + m[i][1] * in[1] + m[i][2] * in[2]) >> MATRIX_SHIFT;
+    }
+}
+
+/**
+ * @brief Кубический корень Q15 -> Q15
+ *
+ * Аргумент умножается на 8, пока не попадёт в [1/8, 1]: cbrt(8x) = 2 cbrt(x),
+ * поэтому результат таблицы затем делится на 2 столько же раз.
+ */
+static int32_t cbrt_q15(int32_t x) {
+    uint32_t shift = 0;
+
+    if (x <= 0) {
+        return 0;
+    }
+    if (x >= OKLAB_ONE) {
+        return m_cbrt_lut[OKLAB_ONE >> CBRT_LUT_SHIFT];
+    }
+    while (x < (OKLAB_ONE >> 3)) {
+        x <<= 3;
+        shift++;
+    }
+
+    uint32_t index = (uint32_t)x >> CBRT_LUT_SHIFT;
+    int32_t frac = x & ((1 << CBRT_LUT_SHIFT) - 1);
+    int32_t lo = m_cbrt_lut[index];
+    int32_t y = lo + (((m_cbrt_lut[index + 1] - lo) * frac) >> CBRT_LUT_SHIFT);
+
+    return y >> shift;
+}
+
+/**
+ * @brief Куб Q15 -> Q15
+ */
+static inline int32_t cube_q15(int32_t x) {
+    if (x > OKLAB_LMS_LIMIT) x = OKLAB_LMS_LIMIT;
+    if (x < -OKLAB_LMS_LIMIT) x = -OKLAB_LMS_LIMIT;
+    int32_t x2 = (x * x) >> 15;
+    return (x2 * x) >> 15;
+}
+
+/**
+ * @brief Синус двоичного угла, Q15
+ */
+static int32_t sin_bam(uint16_t angle) {
+    uint32_t quadrant = angle >> 14;
+    uint32_t offset = angle & 0x3FFF;
+
+    if (quadrant & 1) {
+        offset = 0x4000 - offset;
+    }
+
+    uint32_t index = offset >> TRIG_LUT_SHIFT;
+    int32_t frac = offset & ((1 << TRIG_LUT_SHIFT) - 1);
+    int32_t y = m_sin_lut[index];
+    if (index < 64) {
+        y += ((m_sin_lut[index + 1] - y) * frac) >> TRIG_LUT_SHIFT;
+    }
+
+    return (quadrant & 2) ? -y : y;
+}
+
+/**
+ * @brief Арктангенс y/x, двоичный угол
+ */
+static uint16_t atan2_bam(int32_t y, int32_t x) {
+    uint32_t ax = (uint32_t)(x < 0 ? -x : x);
+    uint32_t ay = (uint32_t)(y < 0 ? -y : y);
+    bool swap = ay > ax;
+
+    if (ax == 0 && ay == 0) {
+        return 0;
+    }
+
+    // Отношение меньшего катета к большему: 0..1 с 8 дробными битами шага таблицы
+    uint32_t num = swap ? ax : ay;
+    uint32_t den = swap ? ay : ax;
+    uint32_t ratio = (num << (ATAN_LUT_BITS + 8)) / den;
+    uint32_t index = ratio >> 8;
+    int32_t frac = ratio & 0xFF;
+    int32_t angle = m_atan_lut[index];
+    if (index < (1 << ATAN_LUT_BITS)) {
+        angle += ((m_atan_lut[index + 1] - angle) * frac) >> 8;
+    }
+
+    if (swap) angle = 0x4000 - angle;
+    if (x < 0) angle = 0x8000 - angle;
+    if (y < 0) angle = 0x10000 - angle;
+
+    return (uint16_t)angle;
+}
+
+/**
+ * @brief Целый квадратный корень
+ */
+static uint32_t isqrt32(uint32_t x) {
+    uint32_t result = 0;
+    uint32_t bit = 1UL << 30;
+
+    while (bit > x) {
+        bit >>= 2;
+    }
+    while (bit) {
+        if (x >= result + bit) {
+            x -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return result;
+}
+
+void oklab_from_rgb(uint32_t r, uint32_t g, uint32_t b, oklab_t * p_lab) {
+    int32_t rgb[3] = { (int32_t)r, (int32_t)g, (int32_t)b };
+    int32_t lms[3];
+
+    matrix_apply(m_rgb_to_lms, rgb, lms);
+    for (int i = 0; i < 3; i++) {
+        lms[i] = cbrt_q15(lms[i]);
+    }
+
+    int32_t lab[3];
+    matrix_apply(m_lms_to_lab, lms, lab);
+    p_lab->L = lab[0];
+    p_lab->a = lab[1];
+    p_lab->b = lab[2];
+}
+
+void oklab_to_rgb(oklab_t const * p_lab, uint32_t * p_r, uint32_t * p_g, uint32_t * p_b) {
+    int32_t lab[3] = { p_lab->L, p_lab->a, p_lab->b };
+    int32_t lms[3];
+    int32_t rgb[3];
+
+    matrix_apply(m_lab_to_lms, lab, lms);
+    for (int i = 0; i < 3; i++) {
+        lms[i] = cube_q15(lms[i]);
+    }
+    matrix_apply(m_lms_to_rgb, lms, rgb);
+
+    for (int i = 0; i < 3; i++) {
+        if (rgb[i] < 0) rgb[i] = 0;
+        if (rgb[i] > OKLAB_ONE - 1) rgb[i] = OKLAB_ONE - 1;
+    }
+
+    *p_r = (uint32_t)rgb[0];
+    *p_g = (uint32_t)rgb[1];
+    *p_b = (uint32_t)rgb[2];
+}
+
+void oklch_from_oklab(oklab_t const * p_lab, oklch_t * p_lch) {
+    p_lch->L = p_lab->L;
+    p_lch->C = (int32_t)isqrt32((uint32_t)(p_lab->a * p_lab->a) + (uint32_t)(p_lab->b * p_lab->b));
+    p_lch->h = atan2_bam(p_lab->b, p_lab->a);
+}
+
+void oklab_from_oklch(oklch_t const * p_lch, oklab_t * p_lab) {
+    p_lab->L = p_lch->L;
+    p_lab->a = (p_lch->C * sin_bam((uint16_t)(p_lch->h + 0x4000))) >> 15;
+    p_lab->b = (p_lch->C * sin_bam(p_lch->h)) >> 15;
+}
+
+/**
+ * @brief Линейная интерполяция Q15
+ */
+static inline int32_t lerp(int32_t from, int32_t to, uint32_t t) {
+    return from + (int32_t)(((int64_t)(to - from) * t) >> 15);
+}
+
+void oklab_mix(oklab_t const * p_from, oklab_t const * p_to, uint32_t t, oklab_t * p_out) {
+    p_out->L = lerp(p_from->L, p_to->L, t);
+    p_out->a = lerp(p_from->a, p_to->a, t);
+    p_out->b = lerp(p_from->b, p_to->b, t);
+}
+
+void oklch_mix(oklab_t const * p_from, oklab_t const * p_to, uint32_t t, oklab_t * p_out) {
+    oklch_t from, to, mix;
+
+    oklch_from_oklab(p_from, &from);
+    oklch_from_oklab(p_to, &to);
+
+    if (from.C < OKLAB_ACHROMATIC) {
+        from.h = to.h;
+    } else if (to.C < OKLAB_ACHROMATIC) {
+        to.h = from.h;
+    }
+
+    // Разность углов по модулю оборота - кратчайшая дуга
+    int16_t delta = (int16_t)(uint16_t)(to.h - from.h);
+
+    mix.L = lerp(from.L, to.L, t);
+    mix.C = lerp(from.C, to.C, t);
+    mix.h = (uint16_t)(from.h + (((int32_t)delta * (int32_t)t) >> 15));
+
+    oklab_from_oklch(&mix, p_out);
+}
+
+void oklab_transition_start(oklab_transition_t * p_transition, uint32_t const from_rgb[3],
+                            uint32_t duration_ms, bool polar) {
+    oklab_from_rgb(from_rgb[0], from_rgb[1], from_rgb[2], &p_transition->from);
+    p_transition->duration_ms = duration_ms;
+    p_transition->elapsed_ms = 0;
+    p_transition->polar = polar;
+}
+
+bool oklab_transition_step(oklab_transition_t * p_transition, uint32_t const to_rgb[3],
+                           uint32_t dt_ms, uint32_t out_rgb[3]) {
+    p_transition->elapsed_ms += dt_ms;
+    if (p_transition->elapsed_ms >= p_transition->duration_ms) {
+        p_transition->elapsed_ms = p_transition->duration_ms;
+        out_rgb[0] = to_rgb[0];
+        out_rgb[1] = to_rgb[1];
+        out_rgb[2] = to_rgb[2];
+        return false;
+    }
+
+    oklab_t to, mix;
+    uint32_t t = (uint32_t)(((uint64_t)p_transition->elapsed_ms << 15) / p_transition->duration_ms);
+
+    oklab_from_rgb(to_rgb[0], to_rgb[1], to_rgb[2], &to);
+    if (p_transition->polar) {
+        oklch_mix(&p_transition->from, &to, t, &mix);
+    } else {
+        oklab_mix(&p_transition->from, &to, t, &mix);
+    }
+    oklab_to_rgb(&mix, &out_rgb[0], &out_rgb[1], &out_rgb[2]);
+
+    return true;
+}
+
+void oklab_benchmark(uint32_t pixels, uint32_t tick_us, oklab_benchmark_t * p_result) {
+    static oklab_t labs[OKLAB_BENCH_COLORS];
+    volatile uint32_t sink = 0;
+    uint32_t r, g, b;
+
+    cycle_counter_init();
+
+    uint32_t start = cycle_counter_get();
+    for (uint32_t i = 0; i < OKLAB_BENCH_COLORS; i++) {
+        oklab_from_rgb((i * 4099) & 0x7FFF, (i * 9973) & 0x7FFF, (i * 2053) & 0x7FFF, &labs[i]);
+    }
+    p_result->to_lab_cycles = (cycle_counter_get() - start) / OKLAB_BENCH_COLORS;
+
+    start = cycle_counter_get();
+    for (uint32_t i = 0; i < OKLAB_BENCH_COLORS; i++) {
+        oklab_to_rgb(&labs[i], &r, &g, &b);
+        sink = r;
+    }
+    p_result->to_rgb_cycles = (cycle_counter_get() - start) / OKLAB_BENCH_COLORS;
+
+    // Шаг перехода: новый конечный цвет -> OKLab, смешение в OKLCH, обратно в RGB
+    oklab_transition_t transition;
+    uint32_t from[3] = { 0, 0, 0 };
+    uint32_t out[3];
+    oklab_transition_start(&transition, from, UINT32_MAX, true);
+    start = cycle_counter_get();
+    for (uint32_t i = 0; i < OKLAB_BENCH_COLORS; i++) {
+        uint32_t to[3] = { (i * 4099) & 0x7FFF, (i * 9973) & 0x7FFF, (i * 2053) & 0x7FFF };
+        oklab_transition_step(&transition, to, 1, out);
+        sink = out[0];
+    }
+    p_result->step_cycles = (cycle_counter_get() - start) / OKLAB_BENCH_COLORS;
+
+    p_result->frame_cycles = p_result->step_cycles * pixels;
+    uint64_t tick_cycles = (uint64_t)tick_us * (CYCLE_COUNTER_FREQ_HZ / 1000000UL);
+    p_result->budget_permille = tick_cycles ? (uint32_t)((uint64_t)p_result->frame_cycles * 1000 / tick_cycles) : 0;
+
+    (void)sink;
+}
@@ -0,0 +1,125 @@
+#ifndef OKLAB_H__
+#define OKLAB_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define OKLAB_ONE           32768   /**< 1.0 в Q15 */
+#define OKLAB_CHROMA_MAX    10813   /**< Наибольшая цветность OKLCH для sRGB (~0.33), Q15 */
+#define OKLAB_HUE_TURN      65536   /**< Полный оборот оттенка OKLCH (двоичный угол) */
+
+/**
+ * @brief Цвет в OKLab, Q15
+ */
+typedef struct {
+    int32_t L;      /**< Светлота 0..OKLAB_ONE */
+    int32_t a;      /**< Зелёный - красный */
+    int32_t b;      /**< Синий - жёлтый */
+} oklab_t;
+
+/**
+ * @brief Цвет в OKLCH
+ */
+typedef struct {
+    int32_t  L;     /**< Светлота, Q15 */
+    int32_t  C;     /**< Цветность, Q15 */
+    uint16_t h;     /**< Оттенок, двоичный угол (OKLAB_HUE_TURN на оборот) */
+} oklch_t;
+
+/**
+ * @brief Плавный переход между цветами
+ */
+typedef struct {
+    oklab_t  from;          /**< Начальный цвет */
+    uint32_t duration_ms;   /**< Длительность */
+    uint32_t elapsed_ms;    /**< Прошло времени */
+    bool     polar;         /**< true - по дуге OKLCH, false - по прямой OKLab */
+} oklab_transition_t;
+
+/**
+ * @brief Стоимость преобразований и доля бюджета тика
+ */
+typedef struct {
+    uint32_t to_lab_cycles;     /**< Тактов на RGB -> OKLab */
+    uint32_t to_rgb_cycles;     /**< Тактов на OKLab -> RGB */
+    uint32_t step_cycles;       /**< Тактов на шаг перехода по OKLCH (на пиксель) */
+    uint32_t frame_cycles;      /**< Тактов на кадр из pixels пикселей */
+    uint32_t budget_permille;   /**< Доля бюджета тика, 1/1000 */
+} oklab_benchmark_t;
+
+/**
+ * @brief Линейный RGB (Q15) -> OKLab
+ *
+ * Значения скважности светодиодов уже линейны по световому потоку, поэтому
+ * гамма sRGB не применяется. Кубический корень - таблица с линейной
+ * интерполяцией после нормализации аргумента степенями 8.
+ */
+void oklab_from_rgb(uint32_t r, uint32_t g, uint32_t b, oklab_t * p_lab);
+
+/**
+ * @brief OKLab -> линейный RGB (Q15)
+ *
+ * Цвета вне охвата sRGB обрезаются по каналам до 0..OKLAB_ONE-1.
+ */
+void oklab_to_rgb(oklab_t const * p_lab, uint32_t * p_r, uint32_t * p_g, uint32_t * p_b);
+
+/**
+ * @brief OKLab -> OKLCH
+ */
+void oklch_from_oklab(oklab_t const * p_lab, oklch_t * p_lch);
+
+/**
+ * @brief OKLCH -> OKLab
+ */
+void oklab_from_oklch(oklch_t const * p_lch, oklab_t * p_lab);
+
+/**
+ * @brief Смешение по прямой в OKLab
+ * @param t Доля конечного цвета, 0..OKLAB_ONE
+ */
+void oklab_mix(oklab_t const * p_from, oklab_t const * p_to, uint32_t t, oklab_t * p_out);
+
+/**
+ * @brief Смешение в OKLCH: L и C линейно, оттенок по кратчайшей дуге
+ *
+ * У ахроматического конца оттенок не определён - берётся оттенок другого
+ * конца, чтобы переход из серого не проходил через посторонние цвета.
+ *
+ * @param t Доля конечного цвета, 0..OKLAB_ONE
+ */
+void oklch_mix(oklab_t const * p_from, oklab_t const * p_to, uint32_t t, oklab_t * p_out);
+
+/**
+ * @brief Начало перехода из цвета from_rgb
+ * @param p_transition Переход
+ * @param from_rgb Начальный цвет, линейный RGB Q15
+ * @param duration_ms Длительность
+ * @param polar true - по дуге OKLCH, false - по прямой OKLab
+ */
+void oklab_transition_start(oklab_transition_t * p_transition, uint32_t const from_rgb[3],
+                            uint32_t duration_ms, bool polar);
+
+/**
+ * @brief Шаг перехода
+ *
+ * Конечный цвет передаётся на каждом шаге, поэтому он может меняться во
+ * время перехода (например, при удержании кнопки).
+ *
+ * @param p_transition Переход
+ * @param to_rgb Конечный цвет, линейный RGB Q15
+ * @param dt_ms Время с предыдущего шага
+ * @param out_rgb Текущий цвет, линейный RGB Q15
+ * @return true - переход ещё идёт
+ */
+bool oklab_transition_step(oklab_transition_t * p_transition, uint32_t const to_rgb[3],
+                           uint32_t dt_ms, uint32_t out_rgb[3]);
+
+/**
+ * @brief Замер стоимости преобразований
+ * @param pixels Пикселей в кадре
+ * @param tick_us Длительность тика, мкс
+ * @param p_result Результат
+ */
+void oklab_benchmark(uint32_t pixels, uint32_t tick_us, oklab_benchmark_t * p_result);
+
+#endif // OKLAB_H__
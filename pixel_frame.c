@@ -0,0 +1,137 @@
+#include <stddef.h>
+#include <string.h>
+#include "nrf.h"
+#include "app_util.h"
+#include "cycle_counter.h"
+#include "color_model.h"
+#include "pixel_frame.h"
+
+#define PIXEL_FRAME_LEVEL_BITS  8   /**< Разрядность уровней кадра */
+
+STATIC_ASSERT(PIXEL_FRAME_HUE_MAX == COLOR_MODEL_HUE_MAX, "Pixel frame and color models share the hue scale");
+STATIC_ASSERT(offsetof(pixel_frame_t, hue) % 4 == 0 && sizeof(((pixel_frame_t *)0)->hue) % 4 == 0,
+              "SIMD kernel reads pixel planes as 32-bit words");
+
+void pixel_frame_hsv_to_rgb_ref(pixel_frame_t * p_frame) {
+    for (uint32_t i = 0; i < p_frame->count; i++) {
+        uint32_t r, g, b;
+
+        color_hsv_to_rgb(p_frame->hue[i], p_frame->saturation[i], p_frame->value[i],
+                         PIXEL_FRAME_LEVEL_BITS, &r, &g, &b);
+        p_frame->red[i] = (uint16_t)r;
+        p_frame->green[i] = (uint16_t)g;
+        p_frame->blue[i] = (uint16_t)b;
+    }
+}
+
+#if defined(__ARM_FEATURE_DSP) && __ARM_FEATURE_DSP
+
+/**
+ * @brief Раскладка v/p/q/t по каналам согласно сектору
+ */
+static inline void sector_store(pixel_frame_t * p_frame, uint32_t i, uint32_t sector,
+                                uint32_t v, uint32_t p, uint32_t q, uint32_t t) {
+    uint32_t r, g, b;
+
+    switch (sector) {
+        case 0:  r = v; g = t; b = p; break;
+        case 1:  r = q; g = v; b = p; break;
+        case 2:  r = p; g = v; b = t; break;
+        case 3:  r = p; g = q; b = v; break;
+        case 4:  r = t; g = p; b = v; break;
+        default: r = v; g = p; b = q; break;
+    }
+
+    p_frame->red[i] = (uint16_t)r;
+    p_frame->green[i] = (uint16_t)g;
+    p_frame->blue[i] = (uint16_t)b;
+}
+
+/*
+ * То же преобразование, что и color_hsv_to_rgb(): q и t - одна и та же
+ * линейная интерполяция пары (v, p) с весами (256 - f, f), взятыми в
+ * прямом и обратном порядке.
+ */
+
+void pixel_frame_hsv_to_rgb(pixel_frame_t * p_frame) {
+    uint32_t const * p_hue = (uint32_t const *)p_frame->hue;
+    uint32_t const * p_sat = (uint32_t const *)p_frame->saturation;
+    uint32_t const * p_val = (uint32_t const *)p_frame->value;
+    uint32_t pairs = (p_frame->count + 1) / 2;
+
+    for (uint32_t k = 0; k < pairs; k++) {
+        uint32_t hh = p_hue[k];
+        uint32_t ss = p_sat[k];
+        uint32_t vv = p_val[k];
+
+        // Позиция в секторе и её дополнение для обоих пикселей
+        uint32_t ff = hh & 0x00FF00FF;
+        uint32_t inv_ff = __SSUB16(0x01000100, ff);
+
+        // p = v - ceil(v * s / 256) для пары
+        uint32_t vs0 = ((vv & 0xFFFF) * (ss & 0xFFFF) + 255) >> 8;
+        uint32_t vs1 = ((vv >> 16) * (ss >> 16) + 255) >> 8;
+        uint32_t pp = __SSUB16(vv, __PKHBT(vs0, vs1, 16));
+
+        // Пары (v, p) и веса (256 - f, f) для каждого пикселя
+        uint32_t a0 = __PKHBT(vv, pp, 16);
+        uint32_t a1 = __PKHTB(pp, vv, 16);
+        uint32_t w0 = __PKHBT(inv_ff, ff, 16);
+        uint32_t w1 = __PKHTB(ff, inv_ff, 16);
+
+        uint32_t q0 = __SMLAD(a0, w0, 128) >> 8;
+        uint32_t t0 = __SMLADX(a0, w0, 128) >> 8;
+        uint32_t q1 = __SMLAD(a1, w1, 128) >> 8;
+        uint32_t t1 = __SMLADX(a1, w1, 128) >> 8;
+
+        sector_store(p_frame, 2 * k, (hh >> 8) & 0xFF,
+                     vv & 0xFFFF, pp & 0xFFFF, q0, t0);
+        sector_store(p_frame, 2 * k + 1, hh >> 24,
+                     vv >> 16, pp >> 16, q1, t1);
+    }
+}
+
+#else
+
+void pixel_frame_hsv_to_rgb(pixel_frame_t * p_frame) {
+    pixel_frame_hsv_to_rgb_ref(p_frame);
+}
+
+#endif // __ARM_FEATURE_DSP
+
+void pixel_frame_benchmark(pixel_frame_t * p_frame, uint16_t count, pixel_frame_benchmark_t * p_result) {
+    static uint16_t reference[3][PIXEL_FRAME_PIXELS_MAX];
+
+    p_frame->count = count;
+    for (uint32_t i = 0; i < PIXEL_FRAME_PIXELS_MAX; i++) {
+        p_frame->hue[i] = (uint16_t)(i * PIXEL_FRAME_HUE_MAX / PIXEL_FRAME_PIXELS_MAX);
+        p_frame->saturation[i] = (uint16_t)(PIXEL_FRAME_LEVEL_MAX - (i & 0x3F));
+        p_frame->value[i] = (uint16_t)(PIXEL_FRAME_LEVEL_MAX - (i & 0x7F));
+    }
+
+    cycle_counter_init();
+
+    uint32_t start = cycle_counter_get();
+    pixel_frame_hsv_to_rgb_ref(p_frame);
+    p_result->reference_cycles = cycle_counter_get() - start;
+
+    memcpy(reference[0], p_frame->red, sizeof(reference[0]));
+    memcpy(reference[1], p_frame->green, sizeof(reference[1]));
+    memcpy(reference[2], p_frame->blue, sizeof(reference[2]));
+
+    start = cycle_counter_get();
+    pixel_frame_hsv_to_rgb(p_frame);
+    p_result->batch_cycles = cycle_counter_get() - start;
+
+    p_result->pixels = count;
+    p_result->match = memcmp(reference[0], p_frame->red, count * sizeof(uint16_t)) == 0
+                   && memcmp(reference[1], p_frame->green, count * sizeof(uint16_t)) == 0
+                   && memcmp(reference[2], p_frame->blue, count * sizeof(uint16_t)) == 0;
+
+    // пиксели / мкс = pixels * (тактов в мкс) / cycles
+    uint32_t cycles_per_us = CYCLE_COUNTER_FREQ_HZ / 1000000UL;
+    p_result->batch_mpix_per_us = p_result->batch_cycles
+        ? (uint32_t)((uint64_t)count * cycles_per_us * 1000 / p_result->batch_cycles) : 0;
+    p_result->reference_mpix_per_us = p_result->reference_cycles
+        ? (uint32_t)((uint64_t)count * cycles_per_us * 1000 / p_result->reference_cycles) : 0;
+}
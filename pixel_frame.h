@@ -0,0 +1,76 @@
+#ifndef PIXEL_FRAME_H__
+#define PIXEL_FRAME_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef PIXEL_FRAME_PIXELS_MAX
+#define PIXEL_FRAME_PIXELS_MAX  144     /**< Ёмкость кадра, пикселей (чётное) */
+#endif
+
+#define PIXEL_FRAME_HUE_SECTOR  256     /**< Шаг оттенка на сектор цветового круга (60°) */
+#define PIXEL_FRAME_HUE_MAX     (6 * PIXEL_FRAME_HUE_SECTOR)   /**< Оттенок 360°, не включая */
+#define PIXEL_FRAME_LEVEL_MAX   255     /**< 100% насыщенности, яркости и каналов RGB */
+
+/**
+ * @brief Кадр пикселей в раскладке "структура массивов"
+ *
+ * Каждая компонента хранится отдельной плоскостью из 16-битных значений:
+ * два соседних пикселя занимают одно 32-битное слово, что позволяет
+ * обрабатывать их парой SIMD-инструкциями Cortex-M4.
+ */
+typedef struct {
+    uint16_t count;                                 /**< Количество пикселей */
+    uint16_t reserved;                              /**< Выравнивание плоскостей на 32-битное слово */
+    uint16_t hue[PIXEL_FRAME_PIXELS_MAX];           /**< Оттенок, 0..PIXEL_FRAME_HUE_MAX-1 */
+    uint16_t saturation[PIXEL_FRAME_PIXELS_MAX];    /**< Насыщенность, 0..PIXEL_FRAME_LEVEL_MAX */
+    uint16_t value[PIXEL_FRAME_PIXELS_MAX];         /**< Яркость, 0..PIXEL_FRAME_LEVEL_MAX */
+    uint16_t red[PIXEL_FRAME_PIXELS_MAX];           /**< Красный, 0..PIXEL_FRAME_LEVEL_MAX */
+    uint16_t green[PIXEL_FRAME_PIXELS_MAX];         /**< Зелёный, 0..PIXEL_FRAME_LEVEL_MAX */
+    uint16_t blue[PIXEL_FRAME_PIXELS_MAX];          /**< Синий, 0..PIXEL_FRAME_LEVEL_MAX */
+} __attribute__((aligned(4))) pixel_frame_t;
+
+/**
+ * @brief Результат сравнения пакетного и скалярного преобразования
+ */
+typedef struct {
+    uint32_t pixels;                /**< Пикселей в кадре */
+    uint32_t batch_cycles;          /**< Такты пакетного преобразования */
+    uint32_t reference_cycles;      /**< Такты скалярного эталона */
+    uint32_t batch_mpix_per_us;     /**< Пропускная способность пакетного, 1/1000 пикселя в мкс */
+    uint32_t reference_mpix_per_us; /**< Пропускная способность эталона, 1/1000 пикселя в мкс */
+    bool     match;                 /**< Результаты совпали побитно */
+} pixel_frame_benchmark_t;
+
+/**
+ * @brief Пакетное преобразование плоскостей HSV в RGB
+ *
+ * На ядре с DSP-расширением (__ARM_FEATURE_DSP) обрабатывает два пикселя
+ * за проход: обе интерполяции сектора считаются одной __SMLAD/__SMLADX
+ * над парой 16-битных значений. Результат побитно совпадает с
+ * pixel_frame_hsv_to_rgb_ref(). При нечётном count пиксель count тоже
+ * пересчитывается (ёмкость кадра чётная).
+ *
+ * @param p_frame Кадр: вход - hue/saturation/value, выход - red/green/blue
+ */
+void pixel_frame_hsv_to_rgb(pixel_frame_t * p_frame);
+
+/**
+ * @brief Скалярный эталон преобразования HSV в RGB
+ * @param p_frame Кадр
+ */
+void pixel_frame_hsv_to_rgb_ref(pixel_frame_t * p_frame);
+
+/**
+ * @brief Замер пропускной способности пакетного преобразования и эталона
+ *
+ * Плоскости HSV заполняются проходом по всему цветовому кругу, обе
+ * функции выполняются над одним кадром, время берётся из DWT CYCCNT.
+ *
+ * @param p_frame Рабочий кадр (содержимое перезаписывается)
+ * @param count Количество пикселей (не более PIXEL_FRAME_PIXELS_MAX)
+ * @param p_result Результат
+ */
+void pixel_frame_benchmark(pixel_frame_t * p_frame, uint16_t count, pixel_frame_benchmark_t * p_result);
+
+#endif // PIXEL_FRAME_H__
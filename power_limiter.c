@@ -0,0 +1,60 @@
+#include "power_limiter.h"
+
+void power_limiter_init(power_limiter_t * p_limiter, power_limiter_config_t const * p_config) {
+    p_limiter->p_config = p_config;
+    p_limiter->temperature = p_config->temp_start;
+    p_limiter->gain = POWER_LIMITER_GAIN_MAX;
+}
+
+void power_limiter_temperature_set(power_limiter_t * p_limiter, int32_t temperature) {
+    p_limiter->temperature = temperature;
+}
+
+uint32_t power_limiter_budget_get(power_limiter_t const * p_limiter) {
+    power_limiter_config_t const * p_config = p_limiter->p_config;
+
+    if (p_limiter->temperature <= p_config->temp_start) {
+        return p_config->budget_ua;
+    }
+    if (p_limiter->temperature >= p_config->temp_max) {
+        return p_config->budget_min_ua;
+    }
+
+    // Линейно между temp_start и temp_max
+    uint32_t span = (uint32_t)(p_config->temp_max - p_config->temp_start);
+    uint32_t over = (uint32_t)(p_limiter->temperature - p_config->temp_start);
+    return p_config->budget_ua - (uint32_t)((uint64_t)(p_config->budget_ua - p_config->budget_min_ua) * over / span);
+}
+
+void power_limiter_apply(power_limiter_t * p_limiter, uint32_t full_scale, uint32_t rgb[3]) {
+    power_limiter_config_t const * p_config = p_limiter->p_config;
+
+    // Ток светодиода пропорционален скважности его канала
+    uint64_t current_ua = 0;
+    for (int i = 0; i < 3; i++) {
+        current_ua += (uint64_t)rgb[i] * p_config->channel_ua[i] / full_scale;
+    }
+
+    // Индикатору резервируется полный ток: бюджет RGB не следует за его миганием
+    uint32_t budget_ua = power_limiter_budget_get(p_limiter);
+    budget_ua = budget_ua > p_config->indicator_ua ? budget_ua - p_config->indicator_ua : 0;
+
+    uint32_t target = POWER_LIMITER_GAIN_MAX;
+    if (current_ua > budget_ua) {
+        target = (uint32_t)((uint64_t)budget_ua * POWER_LIMITER_GAIN_MAX / current_ua);
+    }
+
+    if (target < p_limiter->gain) {
+        uint32_t step = p_limiter->gain - target;
+        p_limiter->gain -= (uint16_t)(step < POWER_LIMITER_ATTACK_STEP ? step : POWER_LIMITER_ATTACK_STEP);
+    } else {
+        uint32_t step = target - p_limiter->gain;
+        p_limiter->gain += (uint16_t)(step < POWER_LIMITER_RELEASE_STEP ? step : POWER_LIMITER_RELEASE_STEP);
+    }
+
+    if (p_limiter->gain < POWER_LIMITER_GAIN_MAX) {
+        for (int i = 0; i < 3; i++) {
+            rgb[i] = (uint32_t)((uint64_t)rgb[i] * p_limiter->gain / POWER_LIMITER_GAIN_MAX);
+        }
+    }
+}
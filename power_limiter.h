@@ -0,0 +1,78 @@
+#ifndef POWER_LIMITER_H__
+#define POWER_LIMITER_H__
+
+#include <stdint.h>
+#include "color_model.h"
+
+#ifndef POWER_LIMITER_ATTACK_STEP
+#define POWER_LIMITER_ATTACK_STEP   256     /**< Снижение множителя за шаг, Q15 (100% -> 50% за 1.3 с при 20 мс) */
+#endif
+
+#ifndef POWER_LIMITER_RELEASE_STEP
+#define POWER_LIMITER_RELEASE_STEP  32      /**< Рост множителя за шаг, Q15 (50% -> 100% за 10 с при 20 мс) */
+#endif
+
+#define POWER_LIMITER_GAIN_MAX      COLOR_MODEL_LEVEL_MAX   /**< Множитель без ограничения (100%) */
+
+/**
+ * @brief Бюджет тока светодиодов и его снижение при нагреве
+ *
+ * Температура - в единицах TEMP: 0.25 °C.
+ */
+typedef struct {
+    uint32_t channel_ua[3];     /**< Ток красного, зелёного и синего при 100% скважности, мкА */
+    uint32_t indicator_ua;      /**< Ток индикатора при 100% яркости: резервируется в бюджете целиком */
+    uint32_t budget_ua;         /**< Бюджет суммарного тока (RGB и индикатор) до начала снижения */
+    uint32_t budget_min_ua;     /**< Бюджет при temp_max и выше */
+    int32_t  temp_start;        /**< Начало снижения бюджета */
+    int32_t  temp_max;          /**< Бюджет снижен до budget_min_ua */
+} power_limiter_config_t;
+
+/**
+ * @brief Состояние ограничителя
+ *
+ * Только целые числа; от железа не зависит и собирается на хосте.
+ */
+typedef struct {
+    power_limiter_config_t const * p_config;
+    int32_t  temperature;   /**< Последняя температура кристалла, 0.25 °C */
+    uint16_t gain;          /**< Текущий множитель каналов, Q15 */
+} power_limiter_t;
+
+/**
+ * @brief Начальное состояние: без ограничения, температура не выше temp_start
+ * @param p_limiter Состояние
+ * @param p_config Параметры (должны существовать всё время работы)
+ */
+void power_limiter_init(power_limiter_t * p_limiter, power_limiter_config_t const * p_config);
+
+/**
+ * @brief Новое значение температуры кристалла
+ * @param p_limiter Состояние
+ * @param temperature Температура, 0.25 °C (регистр TEMP)
+ */
+void power_limiter_temperature_set(power_limiter_t * p_limiter, int32_t temperature);
+
+/**
+ * @brief Бюджет тока при текущей температуре
+ * @return Ток, мкА
+ */
+uint32_t power_limiter_budget_get(power_limiter_t const * p_limiter);
+
+/**
+ * @brief Шаг ограничителя: оценка тока по скважностям и масштабирование каналов
+ *
+ * Вызывается на каждом тике. Множитель идёт к нужному значению не быстрее
+ * POWER_LIMITER_ATTACK_STEP вниз и POWER_LIMITER_RELEASE_STEP вверх за шаг:
+ * бюджет тепловой, кратковременное превышение допустимо, ступеньки - нет.
+ * Индикатор показывает режим и не гасится: его полный ток indicator_ua
+ * вычитается из бюджета независимо от текущей яркости. Иначе бюджет RGB
+ * менялся бы с миганием индикатора, и множитель шёл бы за ним пилой.
+ *
+ * @param p_limiter Состояние
+ * @param full_scale Значение, соответствующее 100% скважности
+ * @param rgb Яркости каналов; масштабируются на месте
+ */
+void power_limiter_apply(power_limiter_t * p_limiter, uint32_t full_scale, uint32_t rgb[3]);
+
+#endif // POWER_LIMITER_H__
@@ -0,0 +1,143 @@
+#include "nrf.h"
+#include "sdk_config.h"
+#include "app_util_platform.h"
+#include "app_timer.h"
+#include "nrf_pwr_mgmt.h"
+#include "cycle_counter.h"
+#include "power_profile.h"
+#include "power_monitor.h"
+
+static uint64_t m_active_cycles[POWER_MONITOR_CAUSE_COUNT];    /**< Активные такты по причинам */
+static power_monitor_cause_t m_current_cause = POWER_MONITOR_CAUSE_MAIN;    /**< Текущая причина */
+static uint32_t m_cycle_mark;   /**< CYCCNT на момент последнего учёта */
+
+static uint64_t m_wall_ticks;   /**< Накопленные тики RTC */
+static uint32_t m_rtc_mark;     /**< Значение RTC на момент последнего учёта */
+static uint32_t m_wakeups;      /**< Количество пробуждений */
+
+static bool     m_initialized;          /**< RTC запущен, учёт времени возможен */
+static bool     m_pwm_running;          /**< Текущий режим выходов */
+static uint64_t m_pwm_ticks[2];         /**< Тики RTC: [0] - статика, [1] - PWM */
+static uint64_t m_pwm_mark;             /**< m_wall_ticks на момент смены режима */
+
+/**
+ * @brief Относит такты с последней отметки к текущей причине
+ *
+ * Вызывается не реже раза в 67 с (период переполнения CYCCNT на 64 МГц),
+ * что гарантирует основной таймер.
+ */
+static inline void cycles_charge(void) {
+    uint32_t now = cycle_counter_get();
+    m_active_cycles[m_current_cause] += (uint32_t)(now - m_cycle_mark);
+    m_cycle_mark = now;
+}
+
+/**
+ * @brief Учёт прошедшего времени по RTC (переполнение 24 бит раз в 512 с)
+ */
+static inline void wall_update(void) {
+    uint32_t now = app_timer_cnt_get();
+    m_wall_ticks += app_timer_cnt_diff_compute(now, m_rtc_mark);
+    m_rtc_mark = now;
+}
+
+/**
+ * @brief Относит время с последней смены режима выходов к текущему режиму
+ */
+static inline void pwm_ticks_charge(void) {
+    m_pwm_ticks[m_pwm_running ? 1 : 0] += m_wall_ticks - m_pwm_mark;
+    m_pwm_mark = m_wall_ticks;
+}
+
+/**
+ * @brief Ток источника HFCLK, который останавливается вместе с PWM
+ */
+static uint32_t pwm_hfclk_current_ua(void) {
+    switch (power_profile_get()) {
+        case POWER_PROFILE_LOWEST_POWER:
+            return POWER_MONITOR_HFINT_UA;
+        case POWER_PROFILE_BALANCED:
+            return POWER_MONITOR_HFXO_UA;
+        default:
+            return 0;
+    }
+}
+
+void power_monitor_init(void) {
+    cycle_counter_init();
+    m_cycle_mark = cycle_counter_get();
+    m_rtc_mark = app_timer_cnt_get();
+    m_pwm_mark = m_wall_ticks;
+    m_initialized = true;
+}
+
+power_monitor_cause_t power_monitor_enter(power_monitor_cause_t cause) {
+    power_monitor_cause_t prev;
+
+    CRITICAL_REGION_ENTER();
+    cycles_charge();
+    prev = m_current_cause;
+    m_current_cause = cause;
+    CRITICAL_REGION_EXIT();
+
+    return prev;
+}
+
+void power_monitor_exit(power_monitor_cause_t prev) {
+    CRITICAL_REGION_ENTER();
+    cycles_charge();
+    m_current_cause = prev;
+    CRITICAL_REGION_EXIT();
+}
+
+void power_monitor_pwm_state_set(bool running) {
+    CRITICAL_REGION_ENTER();
+    if (m_initialized && running != m_pwm_running) {
+        wall_update();
+        pwm_ticks_charge();
+    }
+    m_pwm_running = running;
+    CRITICAL_REGION_EXIT();
+}
+
+void power_monitor_idle(void) {
+    // Пока ядро спит, CYCCNT стоит, так что сон в активное время не попадает
+    nrf_pwr_mgmt_run();
+
+    CRITICAL_REGION_ENTER();
+    cycles_charge();
+    wall_update();
+    m_wakeups++;
+    CRITICAL_REGION_EXIT();
+}
+
+void power_monitor_stats_get(power_monitor_stats_t * p_stats) {
+    uint64_t active_total = 0;
+
+    CRITICAL_REGION_ENTER();
+    cycles_charge();
+    wall_update();
+
+    p_stats->wall_us = m_wall_ticks * 1000000ULL / APP_TIMER_CLOCK_FREQ;
+    for (uint32_t i = 0; i < POWER_MONITOR_CAUSE_COUNT; i++) {
+        p_stats->active_us[i] = cycle_counter_to_us(m_active_cycles[i]);
+        active_total += p_stats->active_us[i];
+    }
+    p_stats->wakeups = m_wakeups;
+
+    pwm_ticks_charge();
+    p_stats->pwm_running_us = m_pwm_ticks[1] * 1000000ULL / APP_TIMER_CLOCK_FREQ;
+    p_stats->pwm_static_us  = m_pwm_ticks[0] * 1000000ULL / APP_TIMER_CLOCK_FREQ;
+    CRITICAL_REGION_EXIT();
+
+    p_stats->pwm_current_ua = POWER_MONITOR_PWM_RUN_UA + pwm_hfclk_current_ua();
+    p_stats->pwm_saved_uc = (uint32_t)(p_stats->pwm_static_us * p_stats->pwm_current_ua / 1000000ULL);
+
+    p_stats->sleep_us = (p_stats->wall_us > active_total) ? (p_stats->wall_us - active_total) : 0;
+
+#if NRF_PWR_MGMT_CONFIG_CPU_USAGE_MONITOR_ENABLED
+    p_stats->cpu_usage_max = nrf_pwr_mgmt_cpu_usage_get();
+#else
+    p_stats->cpu_usage_max = 0;
+#endif
+}
@@ -0,0 +1,92 @@
+#ifndef POWER_MONITOR_H__
+#define POWER_MONITOR_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Токи, которые перестают потребляться при остановке PWM, мкА
+ *
+ * Типовые значения из раздела Current consumption nRF52840 Product
+ * Specification v1.7: ток самого PWM при тактировании 16 МГц и ток
+ * источника HFCLK, который держится только ради PWM: HFINT в профиле
+ * POWER_PROFILE_LOWEST_POWER, HFXO в POWER_PROFILE_BALANCED. В
+ * POWER_PROFILE_HIGHEST_ACCURACY HFXO работает и без PWM.
+ * Расчёт сэкономленного заряда верен, пока HFCLK не держит кто-то ещё
+ * (при подключённом USB HFXO работает всё время, но и питание не от батареи).
+ * После измерения на плате значения переопределяются из Makefile.
+ */
+#ifndef POWER_MONITOR_PWM_RUN_UA
+#define POWER_MONITOR_PWM_RUN_UA    200
+#endif
+
+#ifndef POWER_MONITOR_HFINT_UA
+#define POWER_MONITOR_HFINT_UA      60
+#endif
+
+#ifndef POWER_MONITOR_HFXO_UA
+#define POWER_MONITOR_HFXO_UA       250
+#endif
+
+/**
+ * @brief Причины активности процессора
+ */
+typedef enum {
+    POWER_MONITOR_CAUSE_MAIN = 0,   /**< Основной цикл (код вне прерываний) */
+    POWER_MONITOR_CAUSE_TIMER,      /**< Обработчики app_timer */
+    POWER_MONITOR_CAUSE_GPIOTE,     /**< Обработчик кнопки (GPIOTE) */
+    POWER_MONITOR_CAUSE_PWM,        /**< Обновление PWM */
+    POWER_MONITOR_CAUSE_COUNT
+} power_monitor_cause_t;
+
+/**
+ * @brief Накопленная статистика с момента инициализации
+ */
+typedef struct {
+    uint64_t wall_us;                                   /**< Прошедшее время по RTC */
+    uint64_t sleep_us;                                  /**< Время сна (wall - активное) */
+    uint64_t active_us[POWER_MONITOR_CAUSE_COUNT];      /**< Активное время по причинам */
+    uint32_t wakeups;                                   /**< Количество пробуждений */
+    uint8_t  cpu_usage_max;                             /**< Максимальная загрузка CPU за секунду, % (nrf_pwr_mgmt) */
+    uint64_t pwm_running_us;                            /**< Время работы PWM */
+    uint64_t pwm_static_us;                             /**< Время статических уровней GPIO при остановленном PWM */
+    uint32_t pwm_current_ua;                            /**< Ток PWM и HFCLK в текущем профиле, мкА */
+    uint32_t pwm_saved_uc;                              /**< Сэкономленный заряд: pwm_static_us * pwm_current_ua, мкКл */
+} power_monitor_stats_t;
+
+/**
+ * @brief Инициализация монитора. Вызывается после app_timer_init().
+ */
+void power_monitor_init(void);
+
+/**
+ * @brief Начало участка, относящегося к причине cause
+ * @param cause Причина активности
+ * @return Предыдущая причина, передаётся в power_monitor_exit()
+ */
+power_monitor_cause_t power_monitor_enter(power_monitor_cause_t cause);
+
+/**
+ * @brief Конец участка, начатого power_monitor_enter()
+ * @param prev Значение, возвращённое power_monitor_enter()
+ */
+void power_monitor_exit(power_monitor_cause_t prev);
+
+/**
+ * @brief Один проход основного цикла: сон через nrf_pwr_mgmt с учётом времени
+ */
+void power_monitor_idle(void);
+
+/**
+ * @brief Отметка смены режима выходов: PWM или статические уровни GPIO
+ * @param running true - PWM запущен
+ */
+void power_monitor_pwm_state_set(bool running);
+
+/**
+ * @brief Снимок счётчиков
+ * @param p_stats Структура для результата
+ */
+void power_monitor_stats_get(power_monitor_stats_t * p_stats);
+
+#endif // POWER_MONITOR_H__
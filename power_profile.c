@@ -0,0 +1,86 @@
+#include "nrf.h"
+#include "sdk_config.h"
+#include "app_error.h"
+#include "nrfx_power.h"
+#include "nrf_drv_clock.h"
+#include "power_profile.h"
+
+/**
+ * @brief Параметры профиля
+ */
+typedef struct {
+    nrf_clock_lfclk_t lf_src;   /**< Источник LFCLK */
+    bool hfxo_with_pwm;         /**< Запрашивать HFXO, пока работает PWM */
+    bool hfxo_always;           /**< Держать HFXO с запуска */
+} power_profile_desc_t;
+
+static const power_profile_desc_t m_profiles[] = {
+    [POWER_PROFILE_LOWEST_POWER]     = { .lf_src = NRF_CLOCK_LFCLK_Xtal, .hfxo_with_pwm = false, .hfxo_always = false },
+    [POWER_PROFILE_BALANCED]         = { .lf_src = NRF_CLOCK_LFCLK_Xtal, .hfxo_with_pwm = true,  .hfxo_always = false },
+    [POWER_PROFILE_HIGHEST_ACCURACY] = { .lf_src = NRF_CLOCK_LFCLK_Xtal, .hfxo_with_pwm = false, .hfxo_always = true },
+};
+
+static power_profile_t m_profile = POWER_PROFILE;   /**< Активный профиль */
+static bool m_hfxo_requested = false;               /**< HFXO запрошен для PWM */
+static bool m_lfclk_migrate_pending = false;        /**< LFCLK работает от LFRC, профилю нужен другой источник */
+
+void power_profile_init(power_profile_t profile) {
+    m_profile = profile;
+
+    // DC/DC можно включать только при наличии катушек, иначе регулятор не запустится
+    nrfx_power_config_t power_config = {
+        .dcdcen = POWER_PROFILE_DCDC_REG1_PRESENT,
+#if NRF_POWER_HAS_VDDH
+        .dcdcenhv = POWER_PROFILE_DCDC_REG0_PRESENT,
+#endif
+    };
+    nrfx_power_init(&power_config);
+
+    // HFXO нужен и PWM, и USB: запросы считает nrf_drv_clock, запуск проверяется опросом
+    APP_ERROR_CHECK(nrf_drv_clock_init());
+
+    // LFRC запускается за ~0,6 мс против ~0,25 с у LFXO: app_timer стартует сразу,
+    // источник профиля подключается позже (power_profile_lfclk_migrate)
+    m_lfclk_migrate_pending = (m_profiles[profile].lf_src != NRF_CLOCK_LFCLK_RC);
+    nrf_clock_lf_src_set(NRF_CLOCK_LFCLK_RC);
+    nrf_drv_clock_lfclk_request(NULL);
+
+    // Запрос не снимается: PWM с первого периода и все таймеры HFCLK работают от кварца
+    if (m_profiles[profile].hfxo_always) {
+        nrf_drv_clock_hfclk_request(NULL);
+    }
+}
+
+void power_profile_lfclk_migrate(void) {
+    if (!m_lfclk_migrate_pending) {
+        return;
+    }
+    m_lfclk_migrate_pending = false;
+
+    // Источник меняется только при остановленном LFCLK
+    nrf_drv_clock_lfclk_release();
+    nrf_clock_lf_src_set(m_profiles[m_profile].lf_src);
+    nrf_drv_clock_lfclk_request(NULL);
+}
+
+bool power_profile_lfclk_migrate_pending(void) {
+    return m_lfclk_migrate_pending;
+}
+
+power_profile_t power_profile_get(void) {
+    return m_profile;
+}
+
+void power_profile_pwm_active(bool active) {
+    if (!m_profiles[m_profile].hfxo_with_pwm || active == m_hfxo_requested) {
+        return;
+    }
+
+    // PWM стартует от HFINT и переходит на HFXO, как только тот запустится
+    if (active) {
+        nrf_drv_clock_hfclk_request(NULL);
+    } else {
+        nrf_drv_clock_hfclk_release();
+    }
+    m_hfxo_requested = active;
+}
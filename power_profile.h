@@ -0,0 +1,75 @@
+#ifndef POWER_PROFILE_H__
+#define POWER_PROFILE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "board.h"
+
+/**
+ * @brief Профили питания и тактирования
+ */
+typedef enum {
+    POWER_PROFILE_LOWEST_POWER = 0, /**< LFXO, PWM от HFINT (частота PWM - с точностью HFINT, ~1%) */
+    POWER_PROFILE_BALANCED,         /**< LFXO, HFXO по запросу - только на время работы PWM */
+    POWER_PROFILE_HIGHEST_ACCURACY  /**< LFXO, HFXO с запуска и до выключения, в том числе при остановленном PWM */
+} power_profile_t;
+
+#ifndef POWER_PROFILE
+#define POWER_PROFILE   POWER_PROFILE_BALANCED  /**< Профиль по умолчанию */
+#endif
+
+/* Наличие катушек DC/DC на плате: REG1 (DCDCEN) и REG0 (DCDCEN0, питание от VDDH) */
+#ifndef POWER_PROFILE_DCDC_REG1_PRESENT
+#define POWER_PROFILE_DCDC_REG1_PRESENT BOARD_DCDC_REG1_PRESENT
+#endif
+
+#ifndef POWER_PROFILE_DCDC_REG0_PRESENT
+#define POWER_PROFILE_DCDC_REG0_PRESENT BOARD_DCDC_REG0_PRESENT
+#endif
+
+/**
+ * @brief Включает DC/DC и запускает LFCLK от LFRC
+ *
+ * Не ждёт запуска LFCLK - это остаётся на вызывающей стороне. Если
+ * профилю нужен LFXO, он подключается power_profile_lfclk_migrate().
+ *
+ * @param profile Профиль питания
+ */
+void power_profile_init(power_profile_t profile);
+
+/**
+ * @brief Переводит LFCLK на источник профиля
+ *
+ * Это не фоновое переключение: nRF52 меняет LFCLKSRC только при
+ * остановленном LFCLK, поэтому LFCLK останавливается и запускается заново
+ * от LFXO. До запуска кварца (~0,25 с) стоят все RTC: app_timer на RTC1
+ * (таймеры сдвигаются на это время), hal_clock_ms() и RTC2 опроса
+ * освещённости. WDT до вызова должен быть выключен: он
+ * держит LFCLK и не дал бы его остановить. Выходы PWM тактируются от
+ * HFCLK и продолжают работать. Функция возвращается сразу после запроса,
+ * не дожидаясь LFXO. Повторные вызовы ничего не делают.
+ */
+void power_profile_lfclk_migrate(void);
+
+/**
+ * @brief Переход на источник профиля ещё не выполнен
+ */
+bool power_profile_lfclk_migrate_pending(void);
+
+/**
+ * @brief Текущий профиль
+ */
+power_profile_t power_profile_get(void);
+
+/**
+ * @brief Уведомление о запуске/остановке PWM
+ *
+ * В профиле POWER_PROFILE_BALANCED на время работы PWM запрашивается
+ * HFXO. В POWER_PROFILE_HIGHEST_ACCURACY HFXO запрошен постоянно, в
+ * POWER_PROFILE_LOWEST_POWER PWM тактируется от HFINT.
+ *
+ * @param active true - PWM запущен
+ */
+void power_profile_pwm_active(bool active);
+
+#endif // POWER_PROFILE_H__
@@ -0,0 +1,202 @@
+/**
+ * @brief Замер вычислительных ядер в QEMU (mps2-an386, Cortex-M4F)
+ *
+ * Голый образ без SDK-драйверов: те же исходники цветовых моделей, OKLab,
+ * кадра пикселей и автоматов ввода/анимации, собранные с флагами прошивки
+ * (Thumb-2, FPv4-SP). Время - SysTick в пересчёте на инструкции
+ * (cycle_counter.h, CYCLE_COUNTER_SYSTICK) при запуске с -icount shift=0.
+ *
+ * Результаты печатаются через semihosting строками "BENCH <имя> <инструкций>",
+ * код выхода QEMU ненулевой, если проверка ядра не прошла.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nrf.h"
+#include "cycle_counter.h"
+#include "color_model.h"
+#include "oklab.h"
+#include "pixel_frame.h"
+#include "animation.h"
+#include "gesture.h"
+
+#define QEMU_BENCH_CONVERSIONS  1000    /**< Преобразований на модель */
+#define QEMU_BENCH_PIXELS       60      /**< Пикселей в кадре ленты (как WS2812_PIXEL_COUNT) */
+#define QEMU_BENCH_TICK_US      20000   /**< Тик основного таймера */
+#define QEMU_BENCH_STEPS        1000    /**< Шагов анимации и нажатий */
+#define QEMU_BENCH_FULL_SCALE   64000   /**< Яркость 100% (PWM_PROFILE_STANDARD с дизерингом) */
+
+#define SEMIHOSTING_SYS_WRITE0  0x04
+#define SEMIHOSTING_SYS_EXIT    0x18
+#define ADP_STOPPED_APPLICATION_EXIT    0x20026
+#define ADP_STOPPED_RUNTIME_ERROR       0x20023
+
+volatile uint32_t cycle_counter_systick_wraps;
+
+static pixel_frame_t m_frame;   /**< Рабочий кадр */
+
+static uint32_t semihosting_call(uint32_t operation, void const * p_argument) {
+    register uint32_t r0 __asm__("r0") = operation;
+    register void const * r1 __asm__("r1") = p_argument;
+
+    __asm__ volatile ("bkpt 0xAB" : "+r"(r0) : "r"(r1) : "memory");
+    return r0;
+}
+
+static void __attribute__((noreturn)) semihosting_exit(uint32_t reason) {
+    while (true) {
+        semihosting_call(SEMIHOSTING_SYS_EXIT, (void const *)(uintptr_t)reason);
+    }
+}
+
+/**
+ * @brief Строка "BENCH <name> <value>" без printf (stdio не тянется в образ)
+ */
+static void report(const char * p_name, uint32_t value) {
+    char line[80];
+    char digits[10];
+    uint32_t length = 0;
+    uint32_t count = 0;
+
+    for (const char * p = "BENCH "; *p != '\0'; p++) {
+        line[length++] = *p;
+    }
+    for (const char * p = p_name; *p != '\0' && length < sizeof(line) - 14; p++) {
+        line[length++] = *p;
+    }
+    line[length++] = ' ';
+    do {
+        digits[count++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    while (count > 0) {
+        line[length++] = digits[--count];
+    }
+    line[length++] = '\n';
+    line[length] = '\0';
+
+    semihosting_call(SEMIHOSTING_SYS_WRITE0, line);
+}
+
+/**
+ * @brief Шаг анимации при удержании во всех режимах по очереди
+ */
+static uint32_t animation_bench(void) {
+    animation_t animation;
+    app_state_t state = { .mode = MODE_HUE, .hue = 0.0f, .saturation = 50, .value = 50 };
+
+    animation_init(&animation, QEMU_BENCH_TICK_US / 1000);
+    animation_mode_set(&animation, state.mode, QEMU_BENCH_FULL_SCALE);
+
+    uint32_t start = cycle_counter_get();
+    for (uint32_t i = 0; i < QEMU_BENCH_STEPS; i++) {
+        if ((i & 0xFF) == 0) {
+            state.mode = (input_mode_t)((state.mode + 1) % MODE_COUNT);
+            animation_mode_set(&animation, state.mode, QEMU_BENCH_FULL_SCALE);
+        }
+        animation_step(&animation, &state, true, QEMU_BENCH_FULL_SCALE);
+    }
+    return (cycle_counter_get() - start) / QEMU_BENCH_STEPS;
+}
+
+/**
+ * @brief Нажатие и опрос кнопки с шагом, проходящим все ветви кликов
+ */
+static uint32_t gesture_bench(void) {
+    gesture_t gesture;
+    uint32_t now_ms = 0;
+
+    gesture_init(&gesture);
+
+    uint32_t start = cycle_counter_get();
+    for (uint32_t i = 0; i < QEMU_BENCH_STEPS; i++) {
+        now_ms += 50 + (i * 37) % 400;
+        (void)gesture_press(&gesture, now_ms);
+        gesture_poll(&gesture, now_ms + 20, (i & 1) != 0);
+    }
+    return (cycle_counter_get() - start) / QEMU_BENCH_STEPS;
+}
+
+int main(void) {
+    bool ok = true;
+
+    for (int i = 0; i < COLOR_MODEL_COUNT; i++) {
+        color_model_benchmark_t result;
+        char name[32] = "color_model_";
+        const char * p_model = color_model_get((color_model_t)i)->name;
+        uint32_t length = 12;
+
+        while (*p_model != '\0' && length < sizeof(name) - 1) {
+            name[length++] = *p_model++;
+        }
+        name[length] = '\0';
+
+        color_model_benchmark((color_model_t)i, QEMU_BENCH_CONVERSIONS, &result);
+        report(name, result.cycles_per_conversion);
+    }
+
+    oklab_benchmark_t oklab;
+    oklab_benchmark(QEMU_BENCH_PIXELS, QEMU_BENCH_TICK_US, &oklab);
+    report("oklab_from_rgb", oklab.to_lab_cycles);
+    report("oklab_to_rgb", oklab.to_rgb_cycles);
+    report("oklab_transition_step", oklab.step_cycles);
+
+    pixel_frame_benchmark_t frame;
+    pixel_frame_benchmark(&m_frame, PIXEL_FRAME_PIXELS_MAX, &frame);
+    report("pixel_frame_batch", frame.batch_cycles);
+    report("pixel_frame_reference", frame.reference_cycles);
+    ok = ok && frame.match;
+
+    cycle_counter_init();
+    report("animation_step", animation_bench());
+    report("gesture_press_poll", gesture_bench());
+
+    semihosting_exit(ok ? ADP_STOPPED_APPLICATION_EXIT : ADP_STOPPED_RUNTIME_ERROR);
+}
+
+/* ---------------- Запуск ---------------- */
+
+extern uint32_t __stack_top;
+extern uint32_t __bss_start__;
+extern uint32_t __bss_end__;
+
+void Reset_Handler(void);
+void SysTick_Handler(void);
+
+static void Default_Handler(void) {
+    semihosting_exit(ADP_STOPPED_RUNTIME_ERROR);
+}
+
+void Reset_Handler(void) {
+    for (uint32_t * p = &__bss_start__; p < &__bss_end__; p++) {
+        *p = 0;
+    }
+
+    // FPU до первой инструкции с плавающей точкой
+    SCB->CPACR |= (3UL << 20) | (3UL << 22);
+    __DSB();
+    __ISB();
+
+    main();
+}
+
+void SysTick_Handler(void) {
+    cycle_counter_systick_wraps++;
+}
+
+__attribute__((section(".vectors"), used))
+static void (* const m_vectors[16])(void) = {
+    (void (*)(void))&__stack_top,
+    Reset_Handler,
+    Default_Handler,    /* NMI */
+    Default_Handler,    /* HardFault */
+    Default_Handler,    /* MemManage */
+    Default_Handler,    /* BusFault */
+    Default_Handler,    /* UsageFault */
+    0, 0, 0, 0,
+    Default_Handler,    /* SVCall */
+    Default_Handler,    /* DebugMonitor */
+    0,
+    Default_Handler,    /* PendSV */
+    SysTick_Handler,
+};
@@ -0,0 +1,85 @@
+#include <string.h>
+#include "nrf.h"
+#include "nrf_gpio.h"
+#include "checksum.h"
+#include "system_off.h"
+
+#define RETAINED_MAGIC          0x5EEB0FF5UL    /**< Признак сохранённого состояния */
+
+#define RAM_BASE                0x20000000UL
+#define RAM_SMALL_BLOCKS_SIZE   0x10000UL       /**< RAM[0..7]: по две секции 4 КиБ */
+#define RAM_SMALL_SECTION_SIZE  0x1000UL
+#define RAM_SMALL_BLOCK_SIZE    0x2000UL
+#define RAM_LARGE_BLOCK         8               /**< RAM[8]: шесть секций по 32 КиБ */
+#define RAM_LARGE_SECTION_SIZE  0x8000UL
+
+/**
+ * @brief Сохраняемое между System OFF состояние
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t size;
+    uint32_t checksum;
+    uint8_t  data[SYSTEM_OFF_RETAINED_SIZE];
+} retained_t;
+
+static retained_t m_retained __attribute__((section(".noinit")));   /**< Не обнуляется при старте */
+
+/**
+ * @brief Включает удержание секций RAM, которые занимает [address, address + size)
+ */
+static void ram_retention_enable(uint32_t address, size_t size) {
+    uint32_t end = address + size;
+
+    while (address < end) {
+        uint32_t offset = address - RAM_BASE;
+        uint32_t block, section, section_end;
+
+        if (offset < RAM_SMALL_BLOCKS_SIZE) {
+            block = offset / RAM_SMALL_BLOCK_SIZE;
+            section = (offset % RAM_SMALL_BLOCK_SIZE) / RAM_SMALL_SECTION_SIZE;
+            section_end = RAM_BASE + block * RAM_SMALL_BLOCK_SIZE + (section + 1) * RAM_SMALL_SECTION_SIZE;
+        } else {
+            block = RAM_LARGE_BLOCK;
+            section = (offset - RAM_SMALL_BLOCKS_SIZE) / RAM_LARGE_SECTION_SIZE;
+            section_end = RAM_BASE + RAM_SMALL_BLOCKS_SIZE + (section + 1) * RAM_LARGE_SECTION_SIZE;
+        }
+
+        NRF_POWER->RAM[block].POWERSET = 1UL << (POWER_RAM_POWER_S0RETENTION_Pos + section);
+        address = section_end;
+    }
+}
+
+bool system_off_restore(void * p_data, size_t size) {
+    uint32_t reset_reason = NRF_POWER->RESETREAS;
+    bool valid = (reset_reason & POWER_RESETREAS_OFF_Msk)
+              && m_retained.magic == RETAINED_MAGIC
+              && m_retained.size == size
+              && size <= SYSTEM_OFF_RETAINED_SIZE
+              && m_retained.checksum == checksum_fnv1a(m_retained.data, size);
+
+    if (valid) {
+        memcpy(p_data, m_retained.data, size);
+    }
+
+    NRF_POWER->RESETREAS = POWER_RESETREAS_OFF_Msk;
+    m_retained.magic = 0;
+
+    return valid;
+}
+
+void system_off_prepare(void const * p_data, size_t size, uint32_t wake_pin) {
+    if (size > SYSTEM_OFF_RETAINED_SIZE) {
+        size = SYSTEM_OFF_RETAINED_SIZE;
+    }
+
+    memcpy(m_retained.data, p_data, size);
+    m_retained.size = size;
+    m_retained.checksum = checksum_fnv1a(m_retained.data, size);
+    m_retained.magic = RETAINED_MAGIC;
+
+    ram_retention_enable((uint32_t)&m_retained, sizeof(m_retained));
+
+    // Пробуждение по нажатию кнопки (DETECT)
+    nrf_gpio_cfg_sense_input(wake_pin, NRF_GPIO_PIN_PULLUP, NRF_GPIO_PIN_SENSE_LOW);
+}
@@ -0,0 +1,37 @@
+#ifndef SYSTEM_OFF_H__
+#define SYSTEM_OFF_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SYSTEM_OFF_RETAINED_SIZE    32  /**< Максимальный размер сохраняемого состояния в байтах */
+
+/**
+ * @brief Восстановление состояния после пробуждения из System OFF
+ *
+ * Данные считаются действительными, только если сброс вызван выходом из
+ * System OFF по сигналу DETECT и контрольная сумма совпадает. После чтения
+ * сохранённая копия помечается недействительной.
+ *
+ * @param p_data Буфер для состояния
+ * @param size Размер состояния
+ * @return true, если состояние восстановлено
+ */
+bool system_off_restore(void * p_data, size_t size);
+
+/**
+ * @brief Подготовка к System OFF: сохранение состояния и настройка пробуждения
+ *
+ * Сохраняет состояние в секции .noinit, включает удержание только той
+ * секции RAM, где оно лежит, и настраивает пин кнопки на SENSE низким
+ * уровнем. Вызывается из обработчика nrf_pwr_mgmt на событии
+ * NRF_PWR_MGMT_EVT_PREPARE_SYSOFF; сам переход выполняет nrf_pwr_mgmt.
+ *
+ * @param p_data Состояние приложения
+ * @param size Размер состояния (не больше SYSTEM_OFF_RETAINED_SIZE)
+ * @param wake_pin Пин кнопки (активный низкий уровень)
+ */
+void system_off_prepare(void const * p_data, size_t size, uint32_t wake_pin);
+
+#endif // SYSTEM_OFF_H__
@@ -0,0 +1,189 @@
+/**
+ * @brief Проверка ambient_filter на синтезированных записях датчика освещённости
+ *
+ * Записи в fixtures/ - один отсчёт ambient_level_get() на тик 20 мс.
+ * Они синтезированы по модели датчика (номинальный уровень, шум, новый
+ * отсчёт раз в AMBIENT_PERIOD_MS), а не сняты с платы: проверяется фильтр,
+ * а не датчик. Записи с платы в том же формате добавляются в m_fixtures.
+ * Для каждой записи проверяются:
+ * - шаг множителя за тик не больше AMBIENT_TEST_STEP_MAX (без видимых ступенек);
+ * - установившийся множитель: среднее по хвосту записи совпадает с
+ *   линейной характеристикой для номинального уровня, размах мал;
+ * - переходная характеристика у записей со ступенькой: 63% пути множитель
+ *   проходит за постоянную времени 2^AMBIENT_FILTER_SHIFT тиков, без
+ *   перерегулирования.
+ *
+ * Запуск: ambient_filter_test <каталог записей>
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "ambient_filter.h"
+
+#define AMBIENT_TEST_SAMPLES_MAX    10000   /**< Самая длинная запись, тиков */
+#define AMBIENT_TEST_PATH_MAX       256
+#define AMBIENT_TEST_TAU            (1u << AMBIENT_FILTER_SHIFT)    /**< Постоянная времени, тиков */
+#define AMBIENT_TEST_SETTLE         (5 * AMBIENT_TEST_TAU)  /**< Установление после ступеньки, тиков */
+#define AMBIENT_TEST_STEP_MAX       (AMBIENT_GAIN_MAX / 100)    /**< Шаг множителя за тик: 1% */
+#define AMBIENT_TEST_GAIN_TOLERANCE (AMBIENT_GAIN_MAX / 200)    /**< Установившийся множитель: 0,5% */
+#define AMBIENT_TEST_RIPPLE_MAX     (AMBIENT_GAIN_MAX / 50)     /**< Размах в установившемся режиме при шуме датчика: 2% */
+
+/**
+ * @brief Запись и её номинальные уровни
+ */
+typedef struct {
+    char const * p_file;
+    uint16_t     level_before;  /**< Номинальный уровень до ступеньки */
+    uint16_t     level_after;   /**< Номинальный уровень после ступеньки (без ступеньки - тот же) */
+    uint32_t     step_tick;     /**< Тик ступеньки, 0 - без ступеньки */
+} ambient_fixture_t;
+
+static const ambient_fixture_t m_fixtures[] = {
+    { "ambient_synthetic_step_down.txt",    2600, 600,  500 },
+    { "ambient_synthetic_step_up.txt",      600,  2600, 500 },
+    { "ambient_synthetic_steady_desk.txt",  1600, 1600, 0 },
+    { "ambient_synthetic_night.txt",        50,   50,   0 },
+    { "ambient_synthetic_daylight.txt",     3600, 3600, 0 },
+};
+
+static uint16_t m_samples[AMBIENT_TEST_SAMPLES_MAX];
+static uint16_t m_gain[AMBIENT_TEST_SAMPLES_MAX];
+
+/**
+ * @brief Эталонная характеристика: множитель для постоянного уровня
+ */
+static double gain_expected(uint16_t level) {
+    if (level <= AMBIENT_DARK_LEVEL) {
+        return AMBIENT_GAIN_MIN;
+    }
+    if (level >= AMBIENT_BRIGHT_LEVEL) {
+        return AMBIENT_GAIN_MAX;
+    }
+    return AMBIENT_GAIN_MIN + (double)(level - AMBIENT_DARK_LEVEL) * (AMBIENT_GAIN_MAX - AMBIENT_GAIN_MIN)
+                              / (AMBIENT_BRIGHT_LEVEL - AMBIENT_DARK_LEVEL);
+}
+
+static uint32_t fixture_read(char const * p_path) {
+    FILE * p_file = fopen(p_path, "r");
+    char line[256];
+    uint32_t count = 0;
+
+    if (p_file == NULL) {
+        perror(p_path);
+        exit(2);
+    }
+    while (fgets(line, sizeof(line), p_file) != NULL && count < AMBIENT_TEST_SAMPLES_MAX) {
+        if (line[0] == '#' || line[0] == '\n') {
+            continue;
+        }
+        m_samples[count++] = (uint16_t)strtoul(line, NULL, 10);
+    }
+    fclose(p_file);
+    return count;
+}
+
+static bool fixture_check(ambient_fixture_t const * p_fixture, uint32_t count) {
+    ambient_filter_t filter;
+    bool ok = true;
+
+    ambient_filter_init(&filter);
+    for (uint32_t i = 0; i < count; i++) {
+        m_gain[i] = ambient_filter_update(&filter, m_samples[i]);
+    }
+
+    // Ступеньки за тик
+    uint32_t step_max = 0;
+    for (uint32_t i = 1; i < count; i++) {
+        uint32_t step = (uint32_t)abs((int)m_gain[i] - (int)m_gain[i - 1]);
+        if (step > step_max) {
+            step_max = step;
+        }
+    }
+    if (step_max > AMBIENT_TEST_STEP_MAX) {
+        printf("  gain step %lu per tick > %u\n", (unsigned long)step_max, AMBIENT_TEST_STEP_MAX);
+        ok = false;
+    }
+
+    // Установившийся режим: хвост записи после установления
+    uint32_t settle_start = p_fixture->step_tick + AMBIENT_TEST_SETTLE;
+    if (settle_start >= count) {
+        printf("  recording too short to settle (%lu ticks)\n", (unsigned long)count);
+        return false;
+    }
+    double sum = 0;
+    uint16_t gain_min = UINT16_MAX;
+    uint16_t gain_max = 0;
+    for (uint32_t i = settle_start; i < count; i++) {
+        sum += m_gain[i];
+        gain_min = m_gain[i] < gain_min ? m_gain[i] : gain_min;
+        gain_max = m_gain[i] > gain_max ? m_gain[i] : gain_max;
+    }
+    double mean = sum / (count - settle_start);
+    double expected = gain_expected(p_fixture->level_after);
+    if (mean < expected - AMBIENT_TEST_GAIN_TOLERANCE || mean > expected + AMBIENT_TEST_GAIN_TOLERANCE) {
+        printf("  steady gain %.0f, expected %.0f +- %u\n", mean, expected, AMBIENT_TEST_GAIN_TOLERANCE);
+        ok = false;
+    }
+    if (gain_max - gain_min > AMBIENT_TEST_RIPPLE_MAX) {
+        printf("  steady ripple %u > %u\n", (unsigned)(gain_max - gain_min), AMBIENT_TEST_RIPPLE_MAX);
+        ok = false;
+    }
+
+    // Переходная характеристика
+    uint32_t crossing = 0;
+    if (p_fixture->step_tick != 0) {
+        double from = gain_expected(p_fixture->level_before);
+        double threshold = from + (expected - from) * 0.632;
+        bool rising = expected > from;
+
+        for (uint32_t i = p_fixture->step_tick; i < count; i++) {
+            if (rising ? (m_gain[i] >= threshold) : (m_gain[i] <= threshold)) {
+                crossing = i - p_fixture->step_tick + 1;
+                break;
+            }
+        }
+        if (crossing < AMBIENT_TEST_TAU * 85 / 100 || crossing > AMBIENT_TEST_TAU * 120 / 100) {
+            printf("  63%% of the step after %lu ticks, expected %u -15%%/+20%%\n",
+                   (unsigned long)crossing, AMBIENT_TEST_TAU);
+            ok = false;
+        }
+
+        for (uint32_t i = p_fixture->step_tick; i < count; i++) {
+            double overshoot = rising ? m_gain[i] - expected : expected - m_gain[i];
+            if (overshoot > AMBIENT_TEST_RIPPLE_MAX) {
+                printf("  overshoot %.0f at tick %lu\n", overshoot, (unsigned long)i);
+                ok = false;
+                break;
+            }
+        }
+    }
+
+    printf("%-34s %5lu ticks  steady %5.0f (expected %5.0f)  ripple %3u  max step %3lu",
+           p_fixture->p_file, (unsigned long)count, mean, expected, (unsigned)(gain_max - gain_min),
+           (unsigned long)step_max);
+    if (crossing != 0) {
+        printf("  63%% after %lu ticks", (unsigned long)crossing);
+    }
+    printf("  %s\n", ok ? "OK" : "FAIL");
+    return ok;
+}
+
+int main(int argc, char ** argv) {
+    char path[AMBIENT_TEST_PATH_MAX];
+    int failures = 0;
+
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <fixtures dir>\n", argv[0]);
+        return 2;
+    }
+
+    for (size_t i = 0; i < sizeof(m_fixtures) / sizeof(m_fixtures[0]); i++) {
+        snprintf(path, sizeof(path), "%s/%s", argv[1], m_fixtures[i].p_file);
+        if (!fixture_check(&m_fixtures[i], fixture_read(path))) {
+            failures++;
+        }
+    }
+    return failures != 0;
+}
@@ -0,0 +1,203 @@
+/**
+ * @brief Фаззинг логики приложения на модели HAL
+ *
+ * Вход - заголовок (модель цвета, начальное состояние, температура) и
+ * последовательность событий: каждый байт продвигает время не больше чем
+ * на FUZZ_EVENT_MS_MAX и, если старший бит установлен, меняет состояние
+ * кнопки. Долгие удержания и простой - это цепочки байтов: время на событие
+ * ограничено, чтобы прогон шёл со скоростью событий, а не тиков. Логика собрана с
+ * APP_LOGIC_CHECKS=1: нарушение инвариантов gesture_check() и
+ * animation_check() после любого нажатия или тика уходит в
+ * APP_ERROR_HANDLER, который на хосте вызывает abort().
+ *
+ * С APP_LOGIC_FUZZ_LIBFUZZER=1 собирается только точка входа libFuzzer
+ * (clang -fsanitize=fuzzer). Иначе main() прогоняет файлы из аргументов
+ * или заданное количество случайных входов с фиксированным зерном.
+ *
+ * Запуск: app_logic_fuzz [-n входов] [файл...]
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "app_error.h"
+#include "hal.h"
+#include "app_logic.h"
+#include "color_calib.h"
+#include "gesture.h"
+
+#ifndef APP_LOGIC_FUZZ_LIBFUZZER
+#define APP_LOGIC_FUZZ_LIBFUZZER    0   /**< Только точка входа libFuzzer */
+#endif
+
+#define FUZZ_BUTTON_PIN     5       /**< Пин кнопки модели */
+#define FUZZ_TICK_MS        20      /**< Как MAIN_TIMER_INTERVAL_MS */
+#define FUZZ_HEADER_SIZE    5       /**< Байтов заголовка */
+#define FUZZ_EVENT_MS_MAX   0x7F    /**< Наибольшее продвижение времени за событие (6 тиков) */
+#define FUZZ_IDLE_MS        5000    /**< Тайм-аут простоя: достижим цепочкой из ~40 событий */
+#define FUZZ_RELEASE_MS     (GESTURE_DEBOUNCE_MS + GESTURE_CLICK_WINDOW_MS) /**< Прогон после последнего события: серия кликов завершается */
+#define FUZZ_INPUT_SIZE_MAX 256     /**< Длина случайного входа без libFuzzer */
+#define FUZZ_RUNS_DEFAULT   20000   /**< Случайных входов без libFuzzer */
+
+static const power_limiter_config_t m_limiter_config = {
+    .channel_ua = { 10000, 10000, 10000 },
+    .indicator_ua = 5000,
+    .budget_ua = 35000,
+    .budget_min_ua = 12000,
+    .temp_start = 45 * 4,
+    .temp_max = 70 * 4,
+};
+
+static app_logic_config_t m_config = {
+    .button_pin = FUZZ_BUTTON_PIN,
+    .tick_ms = FUZZ_TICK_MS,
+    .idle_timeout_ms = FUZZ_IDLE_MS,
+};
+
+HAL_TIMER_DEF(m_tick_timer);
+
+static void tick_handler(void * p_context) {
+    (void)p_context;
+    app_state_t state;
+
+    // Запрос выключения не останавливает прогон: логика должна пережить и его
+    (void)app_logic_tick(&state);
+}
+
+static void press_handler(void) {
+    app_logic_press();
+}
+
+/**
+ * @brief Продвижение времени для байта события
+ *
+ * Шаг 1 мс покрывает антидребезг и окна кликов на границах.
+ */
+static uint32_t event_delay_ms(uint8_t event) {
+    return event & FUZZ_EVENT_MS_MAX;
+}
+
+int LLVMFuzzerTestOneInput(uint8_t const * p_data, size_t size) {
+    static bool calib_ready = false;
+
+    if (size < FUZZ_HEADER_SIZE) {
+        return 0;
+    }
+    if (!calib_ready) {
+        // Страница калибровки стёрта: единичная матрица
+        color_calib_init();
+        calib_ready = true;
+    }
+
+    hal_sim_reset();
+
+    hal_output_pins_t pins = { 0 };
+    APP_ERROR_CHECK(hal_output_init(&pins));
+
+    m_config.color_model = (color_model_t)(p_data[0] % COLOR_MODEL_COUNT);
+    m_config.p_limiter = (p_data[0] & 0x80) ? &m_limiter_config : NULL;
+
+    app_state_t state = {
+        .mode = MODE_NO_INPUT,
+        .hue = (float)(p_data[1] * 360 / 256),
+        .saturation = p_data[2] % 101,
+        .value = p_data[3] % 101,
+    };
+    app_logic_init(&m_config, &state, (p_data[4] & 1) ? 400 : 0);
+    app_logic_temperature_set((int32_t)(p_data[4] >> 1) * 4);
+
+    hal_input_init(FUZZ_BUTTON_PIN, press_handler);
+    APP_ERROR_CHECK(hal_timer_create(&m_tick_timer, true, tick_handler));
+    APP_ERROR_CHECK(hal_timer_start(m_tick_timer, FUZZ_TICK_MS, NULL));
+
+    bool pressed = false;
+    for (size_t i = FUZZ_HEADER_SIZE; i < size; i++) {
+        if (p_data[i] & 0x80) {
+            pressed = !pressed;
+            hal_sim_input_set(pressed);
+        }
+        hal_sim_advance(event_delay_ms(p_data[i]));
+    }
+
+    hal_sim_input_set(false);
+    hal_sim_advance(FUZZ_RELEASE_MS);
+    return 0;
+}
+
+#if !APP_LOGIC_FUZZ_LIBFUZZER
+
+/**
+ * @brief Генератор xorshift32: повторяемые входы без libFuzzer
+ */
+static uint32_t random_next(uint32_t * p_seed) {
+    uint32_t x = *p_seed;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *p_seed = x;
+    return x;
+}
+
+static double seconds_now(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+static int run_file(char const * p_path) {
+    static uint8_t buffer[1 << 20];
+    FILE * p_file = fopen(p_path, "rb");
+
+    if (p_file == NULL) {
+        perror(p_path);
+        return 1;
+    }
+    size_t size = fread(buffer, 1, sizeof(buffer), p_file);
+    fclose(p_file);
+
+    LLVMFuzzerTestOneInput(buffer, size);
+    printf("%s: %zu bytes OK\n", p_path, size);
+    return 0;
+}
+
+int main(int argc, char ** argv) {
+    static uint8_t input[FUZZ_INPUT_SIZE_MAX];
+    uint32_t runs = FUZZ_RUNS_DEFAULT;
+    int first_file = 1;
+
+    if (argc > 2 && strcmp(argv[1], "-n") == 0) {
+        runs = (uint32_t)strtoul(argv[2], NULL, 0);
+        first_file = 3;
+    }
+
+    if (first_file < argc) {
+        int errors = 0;
+        for (int i = first_file; i < argc; i++) {
+            errors += run_file(argv[i]);
+        }
+        return errors != 0;
+    }
+
+    uint32_t seed = 0x2545F491UL;
+    uint64_t events = 0;
+    double start = seconds_now();
+    for (uint32_t run = 0; run < runs; run++) {
+        size_t size = FUZZ_HEADER_SIZE + random_next(&seed) % (FUZZ_INPUT_SIZE_MAX - FUZZ_HEADER_SIZE);
+        for (size_t i = 0; i < size; i++) {
+            input[i] = (uint8_t)random_next(&seed);
+        }
+        LLVMFuzzerTestOneInput(input, size);
+        events += size - FUZZ_HEADER_SIZE;
+    }
+    double elapsed = seconds_now() - start;
+    printf("%lu random inputs, %llu events, %.0f events/s: OK\n", (unsigned long)runs, (unsigned long long)events,
+           events / (elapsed > 0 ? elapsed : 1e-9));
+    return 0;
+}
+
+#endif // !APP_LOGIC_FUZZ_LIBFUZZER
@@ -0,0 +1,244 @@
+/**
+ * @brief Сценарии логики приложения с эталонными записями выходов
+ *
+ * Каждый сценарий - последовательность нажатий на модели HAL; выходы
+ * записываются с шагом 1 мс (hal_sim_trace) и сравниваются с эталоном
+ * из golden/<сценарий>.trace с допуском SCENARIO_TOLERANCE.
+ *
+ * Эталон - текст: строки "<отсчётов> <индикатор> <R> <G> <B>", подряд
+ * идущие одинаковые отсчёты сжаты в одну строку.
+ *
+ * Запуск: app_logic_scenarios <каталог эталонов> [--update]
+ * С --update эталоны перезаписываются текущими записями - после
+ * намеренного изменения поведения, с просмотром разницы в git.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "app_error.h"
+#include "hal.h"
+#include "app_logic.h"
+#include "color_calib.h"
+
+#define SCENARIO_BUTTON_PIN     5       /**< Пин кнопки модели */
+#define SCENARIO_TICK_MS        20      /**< Как MAIN_TIMER_INTERVAL_MS */
+#define SCENARIO_SAMPLES_MAX    20000   /**< Самый длинный сценарий, мс */
+#define SCENARIO_TOLERANCE      64      /**< Допуск, единиц полной шкалы (0,1%): округления float */
+#define SCENARIO_CLICK_MS       50      /**< Длительность клика */
+#define SCENARIO_CLICK_GAP_MS   250     /**< Пауза между кликами серии (после антидребезга) */
+#define SCENARIO_PATH_MAX       256
+
+/**
+ * @brief Сценарий: начальное состояние и нажатия
+ */
+typedef struct {
+    char const * p_name;            /**< Имя файла эталона */
+    app_state_t  initial;           /**< Состояние до первого нажатия */
+    void      (* run)(void);        /**< Нажатия и ожидания */
+} scenario_t;
+
+static const app_logic_config_t m_config = {
+    .button_pin = SCENARIO_BUTTON_PIN,
+    .color_model = COLOR_MODEL_HSV,
+    .tick_ms = SCENARIO_TICK_MS,
+    .idle_timeout_ms = 60000,
+    .p_limiter = NULL,
+};
+
+static hal_sim_sample_t m_samples[SCENARIO_SAMPLES_MAX];    /**< Запись прогона */
+static hal_sim_sample_t m_golden[SCENARIO_SAMPLES_MAX];     /**< Эталон */
+
+HAL_TIMER_DEF(m_tick_timer);
+
+static void tick_handler(void * p_context) {
+    (void)p_context;
+    app_state_t state;
+
+    (void)app_logic_tick(&state);
+}
+
+static void press_handler(void) {
+    app_logic_press();
+}
+
+static void click(void) {
+    hal_sim_input_set(true);
+    hal_sim_advance(SCENARIO_CLICK_MS);
+    hal_sim_input_set(false);
+}
+
+static void double_click(void) {
+    click();
+    hal_sim_advance(SCENARIO_CLICK_GAP_MS);
+    click();
+}
+
+static void hold(uint32_t ms) {
+    hal_sim_input_set(true);
+    hal_sim_advance(ms);
+    hal_sim_input_set(false);
+}
+
+/**
+ * @brief Двойной клик в MODE_HUE, удержание 10 с, отпускание
+ */
+static void scenario_hold_hue(void) {
+    double_click();
+    hal_sim_advance(1000);
+    hold(10000);
+    hal_sim_advance(1000);
+}
+
+/**
+ * @brief Из MODE_HUE двойной клик в MODE_SATURATION, удержание 3 с, отпускание
+ */
+static void scenario_hold_saturation(void) {
+    double_click();
+    hal_sim_advance(1000);
+    hold(3000);
+    hal_sim_advance(1000);
+}
+
+static const scenario_t m_scenarios[] = {
+    {
+        .p_name = "hold_hue_10s",
+        .initial = { .mode = MODE_NO_INPUT, .hue = 3.6f, .saturation = 100, .value = 100 },
+        .run = scenario_hold_hue,
+    },
+    {
+        .p_name = "double_click_hold_saturation",
+        .initial = { .mode = MODE_HUE, .hue = 120.0f, .saturation = 100, .value = 80 },
+        .run = scenario_hold_saturation,
+    },
+};
+
+/**
+ * @brief Прогон сценария с записью выходов
+ */
+static void scenario_record(scenario_t const * p_scenario, hal_sim_trace_t * p_trace) {
+    hal_sim_reset();
+
+    hal_output_pins_t pins = { 0 };
+    APP_ERROR_CHECK(hal_output_init(&pins));
+    hal_sim_trace_start(p_trace, m_samples, SCENARIO_SAMPLES_MAX);
+
+    app_logic_init(&m_config, &p_scenario->initial, 0);
+    hal_input_init(SCENARIO_BUTTON_PIN, press_handler);
+    APP_ERROR_CHECK(hal_timer_create(&m_tick_timer, true, tick_handler));
+    APP_ERROR_CHECK(hal_timer_start(m_tick_timer, SCENARIO_TICK_MS, NULL));
+
+    p_scenario->run();
+    hal_sim_trace_stop();
+}
+
+static bool sample_equal(hal_sim_sample_t const * p_a, hal_sim_sample_t const * p_b) {
+    return memcmp(p_a, p_b, sizeof(*p_a)) == 0;
+}
+
+static bool trace_write(char const * p_path, hal_sim_trace_t const * p_trace) {
+    FILE * p_file = fopen(p_path, "w");
+
+    if (p_file == NULL) {
+        perror(p_path);
+        return false;
+    }
+    for (uint32_t i = 0; i < p_trace->count; ) {
+        hal_sim_sample_t const * p_sample = &p_trace->p_samples[i];
+        uint32_t run = 1;
+        while (i + run < p_trace->count && sample_equal(&p_trace->p_samples[i + run], p_sample)) {
+            run++;
+        }
+        fprintf(p_file, "%lu %lu %lu %lu %lu\n", (unsigned long)run, (unsigned long)p_sample->indicator,
+                (unsigned long)p_sample->rgb[0], (unsigned long)p_sample->rgb[1], (unsigned long)p_sample->rgb[2]);
+        i += run;
+    }
+    return fclose(p_file) == 0;
+}
+
+static bool trace_read(char const * p_path, hal_sim_trace_t * p_trace) {
+    FILE * p_file = fopen(p_path, "r");
+    unsigned long run;
+    unsigned long value[4];
+
+    if (p_file == NULL) {
+        perror(p_path);
+        return false;
+    }
+    p_trace->p_samples = m_golden;
+    p_trace->capacity = SCENARIO_SAMPLES_MAX;
+    p_trace->count = 0;
+    while (fscanf(p_file, "%lu %lu %lu %lu %lu", &run, &value[0], &value[1], &value[2], &value[3]) == 5) {
+        for (unsigned long k = 0; k < run; k++) {
+            if (p_trace->count == p_trace->capacity) {
+                fprintf(stderr, "%s: longer than %u ms\n", p_path, SCENARIO_SAMPLES_MAX);
+                fclose(p_file);
+                return false;
+            }
+            hal_sim_sample_t * p_sample = &m_golden[p_trace->count++];
+            p_sample->indicator = (uint32_t)value[0];
+            for (int i = 0; i < 3; i++) {
+                p_sample->rgb[i] = (uint32_t)value[i + 1];
+            }
+        }
+    }
+    fclose(p_file);
+    return true;
+}
+
+static void sample_print(char const * p_label, hal_sim_trace_t const * p_trace, int32_t index) {
+    if ((uint32_t)index >= p_trace->count) {
+        printf("  %-7s (end of trace at %lu ms)\n", p_label, (unsigned long)p_trace->count);
+        return;
+    }
+    hal_sim_sample_t const * p_sample = &p_trace->p_samples[index];
+    printf("  %-7s indicator %6lu  rgb %6lu %6lu %6lu\n", p_label, (unsigned long)p_sample->indicator,
+           (unsigned long)p_sample->rgb[0], (unsigned long)p_sample->rgb[1], (unsigned long)p_sample->rgb[2]);
+}
+
+int main(int argc, char ** argv) {
+    char path[SCENARIO_PATH_MAX];
+    bool update = (argc > 2 && strcmp(argv[2], "--update") == 0);
+    int failures = 0;
+
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <golden dir> [--update]\n", argv[0]);
+        return 2;
+    }
+
+    // Страница калибровки стёрта: единичная матрица
+    color_calib_init();
+
+    for (size_t i = 0; i < sizeof(m_scenarios) / sizeof(m_scenarios[0]); i++) {
+        scenario_t const * p_scenario = &m_scenarios[i];
+        hal_sim_trace_t trace;
+        hal_sim_trace_t golden;
+
+        snprintf(path, sizeof(path), "%s/%s.trace", argv[1], p_scenario->p_name);
+        scenario_record(p_scenario, &trace);
+
+        if (update) {
+            if (!trace_write(path, &trace)) {
+                return 2;
+            }
+            printf("%-32s %6lu ms written to %s\n", p_scenario->p_name, (unsigned long)trace.count, path);
+            continue;
+        }
+
+        if (!trace_read(path, &golden)) {
+            return 2;
+        }
+        int32_t diff = hal_sim_trace_compare(&trace, &golden, SCENARIO_TOLERANCE);
+        if (diff < 0) {
+            printf("%-32s %6lu ms OK\n", p_scenario->p_name, (unsigned long)trace.count);
+        } else {
+            printf("%-32s FAIL at %ld ms (tolerance %u)\n", p_scenario->p_name, (long)diff, SCENARIO_TOLERANCE);
+            sample_print("actual", &trace, diff);
+            sample_print("golden", &golden, diff);
+            failures++;
+        }
+    }
+
+    return failures != 0;
+}
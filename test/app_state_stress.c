@@ -0,0 +1,129 @@
+/**
+ * @brief Нагрузочная проверка seqlock app_state на хосте
+ *
+ * Писатель публикует состояния, все поля которых выводятся из одного
+ * счётчика k; читатель в другом потоке берёт снимки app_state_read() и
+ * проверяет, что поля относятся к одному k. Снимок из двух публикаций -
+ * разорванное чтение.
+ *
+ * Контрольный прогон повторяет то же с общей структурой без seqlock и
+ * показывает, что разрывы этим способом обнаруживаются. Кроме разрывов
+ * проверяется, что снимки не идут назад.
+ *
+ * Запуск: app_state_stress [секунд]
+ */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "app_state.h"
+
+#define STRESS_SECONDS_DEFAULT  2   /**< Длительность каждого прогона по умолчанию */
+
+typedef void (* state_write_t)(app_state_t const * p_state);
+typedef void (* state_read_t)(app_state_t * p_state);
+
+static volatile bool m_stop;            /**< Сигнал остановки писателю */
+static volatile app_state_t m_plain;    /**< Общая структура контрольного прогона */
+
+/**
+ * @brief Состояние для счётчика k: каждое поле однозначно выводится из k
+ */
+static void state_make(uint32_t k, app_state_t * p_state) {
+    p_state->mode = (input_mode_t)(k % MODE_COUNT);
+    p_state->hue = (float)(k % 360);
+    p_state->saturation = (int)(k % 101);
+    p_state->value = (int)((k / 101) % 101);
+    p_state->indicator = k;
+}
+
+static bool state_consistent(app_state_t const * p_state) {
+    app_state_t expected;
+
+    state_make(p_state->indicator, &expected);
+    return p_state->mode == expected.mode
+        && p_state->hue == expected.hue
+        && p_state->saturation == expected.saturation
+        && p_state->value == expected.value;
+}
+
+static void plain_write(app_state_t const * p_state) {
+    m_plain = *p_state;
+}
+
+static void plain_read(app_state_t * p_state) {
+    *p_state = m_plain;
+}
+
+static void * writer_thread(void * p_context) {
+    state_write_t write = (state_write_t)p_context;
+    app_state_t state;
+
+    for (uint32_t k = 1; !m_stop; k++) {
+        state_make(k, &state);
+        write(&state);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Писатель в отдельном потоке, читатель в текущем
+ * @return Количество разорванных снимков и снимков старше уже прочитанных
+ */
+static uint64_t run(char const * p_name, state_write_t write, state_read_t read, unsigned seconds) {
+    pthread_t writer;
+    uint64_t reads = 0;
+    uint64_t torn = 0;
+    uint32_t last = 0;
+    uint64_t backwards = 0;
+    app_state_t state;
+
+    state_make(0, &state);
+    write(&state);
+
+    m_stop = false;
+    if (pthread_create(&writer, NULL, writer_thread, (void *)write) != 0) {
+        fprintf(stderr, "%s: pthread_create failed\n", p_name);
+        exit(2);
+    }
+
+    time_t end = time(NULL) + (time_t)seconds;
+    while (time(NULL) < end) {
+        for (int i = 0; i < 100000; i++) {
+            read(&state);
+            reads++;
+            if (!state_consistent(&state)) {
+                torn++;
+            } else if (state.indicator < last) {
+                backwards++;
+            } else {
+                last = state.indicator;
+            }
+        }
+    }
+
+    m_stop = true;
+    pthread_join(writer, NULL);
+
+    printf("%-10s reads %12llu  latest %10lu  torn %8llu  backwards %llu\n", p_name,
+           (unsigned long long)reads, (unsigned long)last, (unsigned long long)torn,
+           (unsigned long long)backwards);
+    return torn + backwards;
+}
+
+int main(int argc, char ** argv) {
+    unsigned seconds = (argc > 1) ? (unsigned)strtoul(argv[1], NULL, 0) : STRESS_SECONDS_DEFAULT;
+
+    (void)run("unlocked", plain_write, plain_read, seconds);
+    uint64_t errors = run("app_state", app_state_publish, app_state_read, seconds);
+
+    if (errors != 0) {
+        printf("FAIL: app_state_read returned %llu torn or stale snapshots\n", (unsigned long long)errors);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
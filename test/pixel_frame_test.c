@@ -0,0 +1,157 @@
+/**
+ * @brief Проверка пакетного HSV -> RGB из pixel_frame на хосте
+ *
+ * pixel_frame.c собирается с -D__ARM_FEATURE_DSP=1, SIMD-инструкции
+ * Cortex-M4 эмулируются в stubs/nrf.h. Проверяется:
+ * - побитное совпадение pixel_frame_hsv_to_rgb() с
+ *   pixel_frame_hsv_to_rgb_ref() на всех сочетаниях оттенка, насыщенности
+ *   и яркости, в том числе в нечётном по номеру пикселе пары;
+ * - отклонение эталона от HSV в плавающей точке не больше
+ *   PIXEL_TEST_FLOAT_ERROR_MAX единиц младшего разряда.
+ *
+ * Пропускная способность печатается для хоста с эмулированными
+ * инструкциями и не заменяет замер на плате (pixel_frame_benchmark()) или
+ * в QEMU (make qemu_bench).
+ *
+ * Запуск: pixel_frame_test [повторов замера]
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "pixel_frame.h"
+
+#define PIXEL_TEST_FLOAT_ERROR_MAX  1.5     /**< Отклонение от HSV в плавающей точке, LSB */
+#define PIXEL_TEST_REPEATS_DEFAULT  20000   /**< Повторов замера пропускной способности */
+
+static pixel_frame_t m_frame;
+static pixel_frame_t m_reference;
+
+/**
+ * @brief HSV -> RGB в плавающей точке в шкале кадра
+ */
+static void hsv_to_rgb_float(uint32_t hue, uint32_t saturation, uint32_t value, double rgb[3]) {
+    double h = (double)hue / PIXEL_FRAME_HUE_SECTOR;
+    double s = (double)saturation / PIXEL_FRAME_LEVEL_MAX;
+    double v = (double)value;
+    int sector = (int)h;
+    double f = h - sector;
+    double p = v * (1.0 - s);
+    double q = v * (1.0 - s * f);
+    double t = v * (1.0 - s * (1.0 - f));
+
+    switch (sector) {
+        case 0:  rgb[0] = v; rgb[1] = t; rgb[2] = p; break;
+        case 1:  rgb[0] = q; rgb[1] = v; rgb[2] = p; break;
+        case 2:  rgb[0] = p; rgb[1] = v; rgb[2] = t; break;
+        case 3:  rgb[0] = p; rgb[1] = q; rgb[2] = v; break;
+        case 4:  rgb[0] = t; rgb[1] = p; rgb[2] = v; break;
+        default: rgb[0] = v; rgb[1] = p; rgb[2] = q; break;
+    }
+}
+
+/**
+ * @brief Все сочетания H, S и V кадрами по PIXEL_FRAME_PIXELS_MAX
+ * @return Количество несовпавших пикселей
+ */
+static uint64_t exhaustive_check(double * p_float_error) {
+    uint64_t total = (uint64_t)PIXEL_FRAME_HUE_MAX * (PIXEL_FRAME_LEVEL_MAX + 1) * (PIXEL_FRAME_LEVEL_MAX + 1);
+    uint64_t mismatches = 0;
+    double error_max = 0;
+
+    for (uint64_t base = 0; base < total; base += PIXEL_FRAME_PIXELS_MAX) {
+        uint16_t count = (uint16_t)((total - base < PIXEL_FRAME_PIXELS_MAX) ? total - base : PIXEL_FRAME_PIXELS_MAX);
+
+        m_frame.count = count;
+        for (uint32_t i = 0; i < count; i++) {
+            uint64_t n = base + i;
+            m_frame.hue[i] = (uint16_t)(n % PIXEL_FRAME_HUE_MAX);
+            m_frame.saturation[i] = (uint16_t)((n / PIXEL_FRAME_HUE_MAX) % (PIXEL_FRAME_LEVEL_MAX + 1));
+            m_frame.value[i] = (uint16_t)(n / PIXEL_FRAME_HUE_MAX / (PIXEL_FRAME_LEVEL_MAX + 1));
+        }
+        m_reference = m_frame;
+
+        pixel_frame_hsv_to_rgb(&m_frame);
+        pixel_frame_hsv_to_rgb_ref(&m_reference);
+
+        for (uint32_t i = 0; i < count; i++) {
+            uint16_t const actual[3] = { m_frame.red[i], m_frame.green[i], m_frame.blue[i] };
+            uint16_t const expected[3] = { m_reference.red[i], m_reference.green[i], m_reference.blue[i] };
+            double exact[3];
+
+            if (memcmp(actual, expected, sizeof(actual)) != 0) {
+                if (mismatches == 0) {
+                    printf("  first mismatch: hsv %u %u %u -> %u %u %u, reference %u %u %u\n",
+                           m_frame.hue[i], m_frame.saturation[i], m_frame.value[i],
+                           actual[0], actual[1], actual[2], expected[0], expected[1], expected[2]);
+                }
+                mismatches++;
+            }
+
+            hsv_to_rgb_float(m_frame.hue[i], m_frame.saturation[i], m_frame.value[i], exact);
+            for (int c = 0; c < 3; c++) {
+                double error = fabs(expected[c] - exact[c]);
+                error_max = error > error_max ? error : error_max;
+            }
+        }
+    }
+
+    printf("%llu pixels: %llu mismatches, max error vs float %.2f LSB\n",
+           (unsigned long long)total, (unsigned long long)mismatches, error_max);
+    *p_float_error = error_max;
+    return mismatches;
+}
+
+static double seconds_now(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Пикселей в микросекунду на хосте
+ */
+static double throughput(void (* convert)(pixel_frame_t *), uint32_t repeats) {
+    double start = seconds_now();
+
+    for (uint32_t k = 0; k < repeats; k++) {
+        convert(&m_frame);
+        // Компилятор не должен выбрасывать повторы
+        __asm__ volatile("" : : "r"(&m_frame) : "memory");
+    }
+    return (double)repeats * m_frame.count / ((seconds_now() - start) * 1e6);
+}
+
+int main(int argc, char ** argv) {
+    uint32_t repeats = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : PIXEL_TEST_REPEATS_DEFAULT;
+    pixel_frame_benchmark_t benchmark;
+    double float_error;
+    bool ok = true;
+
+    if (exhaustive_check(&float_error) != 0) {
+        ok = false;
+    }
+    if (float_error > PIXEL_TEST_FLOAT_ERROR_MAX) {
+        printf("  error vs float %.2f > %.2f LSB\n", float_error, PIXEL_TEST_FLOAT_ERROR_MAX);
+        ok = false;
+    }
+
+    // Кадр замера на плате: проход по цветовому кругу, нечётное количество пикселей
+    pixel_frame_benchmark(&m_frame, PIXEL_FRAME_PIXELS_MAX - 1, &benchmark);
+    if (!benchmark.match) {
+        printf("  pixel_frame_benchmark: batch and reference differ\n");
+        ok = false;
+    }
+
+    m_frame.count = PIXEL_FRAME_PIXELS_MAX;
+    printf("host, emulated SIMD: batch %.1f pixels/us, reference %.1f pixels/us\n",
+           throughput(pixel_frame_hsv_to_rgb, repeats), throughput(pixel_frame_hsv_to_rgb_ref, repeats));
+
+    printf("%s\n", ok ? "OK" : "FAIL");
+    return ok ? 0 : 1;
+}
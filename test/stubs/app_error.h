@@ -0,0 +1,28 @@
+#ifndef APP_ERROR_H__
+#define APP_ERROR_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "sdk_errors.h"
+
+/**
+ * @brief Замена app_error.h: ошибка останавливает прогон через abort()
+ *
+ * abort() libFuzzer и отладчик считают падением и показывают место.
+ */
+static inline void app_error_host(ret_code_t error, char const * p_file, int line) {
+    fprintf(stderr, "%s:%d: app error 0x%lx\n", p_file, line, (unsigned long)error);
+    abort();
+}
+
+#define APP_ERROR_HANDLER(ERR_CODE)     app_error_host((ERR_CODE), __FILE__, __LINE__)
+
+#define APP_ERROR_CHECK(ERR_CODE)                       \
+    do {                                                \
+        ret_code_t const err_code_ = (ERR_CODE);        \
+        if (err_code_ != NRF_SUCCESS) {                 \
+            APP_ERROR_HANDLER(err_code_);               \
+        }                                               \
+    } while (0)
+
+#endif // APP_ERROR_H__
@@ -0,0 +1,17 @@
+#ifndef APP_UTIL_H__
+#define APP_UTIL_H__
+
+/* Замена app_util.h: макросы, которые используют чистые модули */
+
+#define STATIC_ASSERT(EXPR, ...)    _Static_assert(EXPR, #EXPR)
+#define ARRAY_SIZE(arr)             (sizeof(arr) / sizeof((arr)[0]))
+
+#ifndef MAX
+#define MAX(a, b)                   ((a) < (b) ? (b) : (a))
+#endif
+
+#ifndef MIN
+#define MIN(a, b)                   ((a) < (b) ? (a) : (b))
+#endif
+
+#endif // APP_UTIL_H__
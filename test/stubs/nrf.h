@@ -0,0 +1,75 @@
+#ifndef NRF_H__
+#define NRF_H__
+
+/**
+ * @brief Замена nrf.h для сборки чистых модулей на хосте (test/Makefile)
+ *
+ * Только то, что нужно app_state.c, цветовым модулям, pixel_frame.c и
+ * cycle_counter.h.
+ * Барьеры памяти - полные барьеры компилятора и процессора хоста, чтобы
+ * проверка seqlock с потоками видела тот же порядок, что и на Cortex-M4.
+ */
+
+#include <stdint.h>
+
+#define __DMB() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define __DSB() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define __ISB() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#define __STATIC_INLINE static inline
+
+/* cycle_counter.h: счётчик тактов на хосте не используется, регистры - в RAM */
+typedef struct {
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct {
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+extern DWT_Type       * DWT;
+extern CoreDebug_Type * CoreDebug;
+
+#define DWT_CTRL_CYCCNTENA_Msk      (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk  (1UL << 24)
+
+#if defined(__ARM_FEATURE_DSP) && __ARM_FEATURE_DSP
+
+/*
+ * SIMD-инструкции Cortex-M4 для ядра pixel_frame (test/Makefile собирает его
+ * с -D__ARM_FEATURE_DSP=1): та же семантика, что у cmsis_gcc.h, - половины
+ * слова со знаком, результаты по модулю 2^16 и 2^32.
+ */
+
+static inline int32_t dsp_lo(uint32_t x) {
+    return (int16_t)(x & 0xFFFF);
+}
+
+static inline int32_t dsp_hi(uint32_t x) {
+    return (int16_t)(x >> 16);
+}
+
+static inline uint32_t __SSUB16(uint32_t a, uint32_t b) {
+    return ((uint32_t)(dsp_lo(a) - dsp_lo(b)) & 0xFFFF) | ((uint32_t)(dsp_hi(a) - dsp_hi(b)) << 16);
+}
+
+static inline uint32_t __PKHBT(uint32_t a, uint32_t b, uint32_t shift) {
+    return (a & 0xFFFF) | ((b << shift) & 0xFFFF0000);
+}
+
+static inline uint32_t __PKHTB(uint32_t a, uint32_t b, uint32_t shift) {
+    return (a & 0xFFFF0000) | ((uint32_t)((int32_t)b >> shift) & 0xFFFF);
+}
+
+static inline uint32_t __SMLAD(uint32_t a, uint32_t b, uint32_t acc) {
+    return acc + (uint32_t)(dsp_lo(a) * dsp_lo(b)) + (uint32_t)(dsp_hi(a) * dsp_hi(b));
+}
+
+static inline uint32_t __SMLADX(uint32_t a, uint32_t b, uint32_t acc) {
+    return acc + (uint32_t)(dsp_lo(a) * dsp_hi(b)) + (uint32_t)(dsp_hi(a) * dsp_lo(b));
+}
+
+#endif // __ARM_FEATURE_DSP
+
+#endif // NRF_H__
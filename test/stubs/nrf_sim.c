@@ -0,0 +1,58 @@
+/**
+ * @brief Память и регистры, которые чистые модули берут у платы
+ *
+ * Страница калибровки color_calib (символ __color_calib_start из
+ * blinky_gcc_nrf52.ld) - стёртый массив в RAM с записью через замену
+ * nrfx_nvmc; регистры DWT для cycle_counter.h - тоже в RAM.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "nrf.h"
+#include "nrfx_nvmc.h"
+
+#define FLASH_PAGE_SIZE     4096    /**< Страница flash nRF52840 */
+
+/* Страница калибровки: в прошивке - символ линкера, здесь - стёртый массив */
+uint32_t __color_calib_start[FLASH_PAGE_SIZE / sizeof(uint32_t)] = { [0 ... FLASH_PAGE_SIZE / sizeof(uint32_t) - 1] = 0xFFFFFFFFUL };
+
+static DWT_Type       m_dwt;
+static CoreDebug_Type m_core_debug;
+
+DWT_Type       * DWT = &m_dwt;
+CoreDebug_Type * CoreDebug = &m_core_debug;
+
+/**
+ * @brief Адрес из 32 бит в указатель на странице калибровки
+ *
+ * На 64-битном хосте color_calib.c получает только младшие 32 бита
+ * адреса, поэтому страница одна, а адрес проверяется по смещению.
+ */
+static uint32_t * flash_pointer(uint32_t address) {
+    uint32_t offset = address - (uint32_t)(uintptr_t)__color_calib_start;
+
+    if (offset >= FLASH_PAGE_SIZE) {
+        abort();
+    }
+    return &__color_calib_start[offset / sizeof(uint32_t)];
+}
+
+nrfx_err_t nrfx_nvmc_page_erase(uint32_t address) {
+    memset(flash_pointer(address), 0xFF, FLASH_PAGE_SIZE);
+    return NRF_SUCCESS;
+}
+
+void nrfx_nvmc_words_write(uint32_t address, void const * p_src, uint32_t num_words) {
+    // Запись во flash только сбрасывает биты
+    uint32_t * p_dst = flash_pointer(address);
+    uint32_t const * p_words = (uint32_t const *)p_src;
+    for (uint32_t i = 0; i < num_words; i++) {
+        p_dst[i] &= p_words[i];
+    }
+}
+
+bool nrfx_nvmc_write_done_check(void) {
+    return true;
+}
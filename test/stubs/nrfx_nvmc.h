@@ -0,0 +1,16 @@
+#ifndef NRFX_NVMC_H__
+#define NRFX_NVMC_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sdk_errors.h"
+
+/* Замена nrfx_nvmc.h: страница калибровки - в RAM (nrf_sim.c) */
+
+typedef ret_code_t nrfx_err_t;
+
+nrfx_err_t nrfx_nvmc_page_erase(uint32_t address);
+void nrfx_nvmc_words_write(uint32_t address, void const * p_src, uint32_t num_words);
+bool nrfx_nvmc_write_done_check(void);
+
+#endif // NRFX_NVMC_H__
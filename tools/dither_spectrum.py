@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+"""
+Спектральный анализ сигма-дельта дизеринга PWM.
+
+Повторяет алгоритм pwm_sequence_fill() из main.c и для каждого режима PWM
+считает спектр яркости по периодам: несущая PWM (>= 1 кГц) не видна, но
+чередование скважностей между периодами даёт составляющие на частотах
+f_pwm * m / 2^n. Отчёт показывает частоту повторения последовательности,
+прирост разрешения и наихудшую глубину модуляции на самой низкой частоте.
+Если есть составляющие ниже порога заметного мерцания, код возврата 1.
+"""
+
+import argparse
+import cmath
+import math
+import sys
+
+DITHER_BITS = 4     # PWM_DITHER_BITS
+
+# base clock (Гц), top, биты дизеринга - как в m_pwm_profiles[]
+PROFILES = [
+    ('PWM_PROFILE_STANDARD',    16000000, 4000,  4),
+    ('PWM_PROFILE_HIGH_RES',    16000000, 16000, 2),
+    ('PWM_PROFILE_CAMERA_SAFE', 16000000, 1000,  4),
+]
+
+
+def sequence(fine_value, top, dither_bits):
+    """Скважности по периодам для значения с DITHER_BITS дробными битами."""
+    periods = 1 << dither_bits
+    drop = DITHER_BITS - dither_bits
+    value = (fine_value + ((1 << drop) >> 1)) >> drop
+    whole = value >> dither_bits
+    fraction = value & (periods - 1)
+    accumulator = periods // 2
+    out = []
+    for _ in range(periods):
+        duty = whole
+        accumulator += fraction
+        if accumulator >= periods:
+            accumulator -= periods
+            duty += 1
+        out.append(min(duty, top))
+    return out
+
+
+def spectrum(samples):
+    """Амплитуды гармоник 1..N/2 периодической последовательности."""
+    n = len(samples)
+    result = []
+    for m in range(1, n // 2 + 1):
+        acc = sum(samples[k] * cmath.exp(-2j * math.pi * m * k / n) for k in range(n))
+        amplitude = abs(acc) / n * (1 if m == n - m else 2)
+        result.append((m, amplitude))
+    return result
+
+
+def analyse(name, clock, top, dither_bits, bottom_steps, threshold_hz):
+    f_pwm = clock / top
+    periods = 1 << dither_bits
+    f_pattern = f_pwm / periods
+    worst_depth = 0.0
+    worst_value = None
+    below_threshold = False
+
+    # Низ диапазона: первые bottom_steps шагов исходного разрешения
+    for fine in range(1, bottom_steps << DITHER_BITS):
+        samples = sequence(fine, top, dither_bits)
+        mean = sum(samples) / len(samples)
+        if mean == 0:
+            continue
+        for m, amplitude in spectrum(samples):
+            if amplitude < 1e-9:
+                continue
+            depth = amplitude / mean
+            if m == 1 and depth > worst_depth:
+                worst_depth = depth
+                worst_value = fine
+            if f_pattern * m < threshold_hz:
+                below_threshold = True
+
+    print('%-24s f_pwm %8.0f Hz  %2d periods  pattern %7.1f Hz  +%d bits  '
+          'worst depth %5.1f%% (value %s/%d)  %s'
+          % (name, f_pwm, periods, f_pattern, dither_bits, worst_depth * 100,
+             worst_value, 1 << DITHER_BITS,
+             'FLICKER RISK' if below_threshold else 'ok'))
+    return not below_threshold
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Spectral analysis of PWM sigma-delta dithering')
+    parser.add_argument('--threshold-hz', type=float, default=200.0,
+                        help='частота, ниже которой модуляция считается заметной')
+    parser.add_argument('--bottom-steps', type=int, default=4,
+                        help='сколько нижних шагов скважности анализировать')
+    args = parser.parse_args()
+
+    ok = True
+    for name, clock, top, bits in PROFILES:
+        ok &= analyse(name, clock, top, bits, args.bottom_steps, args.threshold_hz)
+    return 0 if ok else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
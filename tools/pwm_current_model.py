@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+"""
+Модель тока светодиодов для обычного и разнесённого по фазам PWM.
+
+Повторяет pwm_init()/pwm_sequence_fill() из main.c: в обычном режиме
+счётчик идёт вверх и все каналы включаются в начале периода, в режиме
+PWM_STAGGER счётчик идёт вверх-вниз, а нечётные каналы работают с обратной
+полярностью и значением top - duty. Для набора скважностей считает пиковый
+суммарный ток, размах пульсаций и число одновременных включений, а также
+проверяет, что средняя скважность каждого канала совпадает.
+"""
+
+import argparse
+import itertools
+import sys
+
+CHANNELS = ('indicator', 'red', 'green', 'blue')   # порядок m_pwm_pins[]
+POLARITY_FALLING = 0x8000
+
+
+def waveform_up(values, top):
+    """Состояние каналов (True - светодиод горит) в каждом такте периода."""
+    return [[t < v for v in values] for t in range(top)]
+
+
+def waveform_staggered(values, top):
+    """Счёт вверх-вниз: 2 * top тактов, отсчёт в середине такта."""
+    raw = [v if ch % 2 == 0 else (top - v) | POLARITY_FALLING for ch, v in enumerate(values)]
+    states = []
+    for t in range(2 * top):
+        counter = t + 0.5 if t < top else 2 * top - t - 0.5
+        row = []
+        for value in raw:
+            compare = value & ~POLARITY_FALLING
+            if value & POLARITY_FALLING:
+                row.append(counter >= compare)  # высокий до совпадения, затем низкий
+            else:
+                row.append(counter < compare)   # низкий (горит) до совпадения
+        states.append(row)
+    return states
+
+
+def measure(states, currents):
+    totals = [sum(c for on, c in zip(row, currents) if on) for row in states]
+    turn_ons = 0
+    for prev, row in zip(states[-1:] + states[:-1], states):
+        turn_ons = max(turn_ons, sum(1 for a, b in zip(prev, row) if b and not a))
+    duties = [sum(row[ch] for row in states) / float(len(states)) for ch in range(len(currents))]
+    return max(totals), max(totals) - min(totals), turn_ons, duties
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Peak LED current model for staggered PWM')
+    parser.add_argument('--top', type=int, default=100, help='top модели (меньше - быстрее)')
+    parser.add_argument('--currents', type=float, nargs=4, default=[5.0, 5.0, 5.0, 5.0],
+                        metavar='MA', help='ток каналов indicator/red/green/blue, мА')
+    parser.add_argument('--step', type=int, default=20, help='шаг перебора скважностей')
+    args = parser.parse_args()
+
+    top = args.top
+    levels = range(0, top + 1, args.step)
+    worst_up = worst_st = 0.0
+    sum_up = sum_st = 0.0
+    count = 0
+    mismatch = 0
+    edges_up = edges_st = 0
+
+    for values in itertools.product(levels, repeat=len(CHANNELS)):
+        peak_up, ripple_up, on_up, duty_up = measure(waveform_up(values, top), args.currents)
+        peak_st, ripple_st, on_st, duty_st = measure(waveform_staggered(values, top), args.currents)
+        for ch, value in enumerate(values):
+            expected = value / float(top)
+            if abs(duty_up[ch] - expected) > 1e-12 or abs(duty_st[ch] - expected) > 1e-12:
+                mismatch += 1
+        worst_up = max(worst_up, peak_up)
+        worst_st = max(worst_st, peak_st)
+        sum_up += peak_up
+        sum_st += peak_st
+        edges_up = max(edges_up, on_up)
+        edges_st = max(edges_st, on_st)
+        count += 1
+
+    print('%d duty combinations, top %d' % (count, top))
+    print('  %-28s %10s %10s' % ('', 'UP', 'STAGGER'))
+    print('  %-28s %10.1f %10.1f' % ('worst peak current, mA', worst_up, worst_st))
+    print('  %-28s %10.2f %10.2f' % ('mean peak current, mA', sum_up / count, sum_st / count))
+    print('  %-28s %10d %10d' % ('max simultaneous turn-ons', edges_up, edges_st))
+    print('  mean peak reduction: %.1f%%' % (100.0 * (1.0 - sum_st / sum_up) if sum_up else 0.0))
+
+    if mismatch:
+        print('Average duty mismatch in %d channel(s)' % mismatch)
+        return 1
+    print('Average duty preserved for all channels')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+"""
+Замер вычислительных ядер в QEMU по количеству инструкций.
+
+Запускает образ qemu/qemu_bench.c на mps2-an386 (Cortex-M4F) с -icount,
+собирает строки "BENCH <имя> <инструкций>" из вывода semihosting и печатает
+их. При наличии базового файла сравнивает с ним и завершается с ненулевым
+кодом, если какое-либо ядро стало дороже порога (в процентах) или пропало
+из вывода. Новые ядра без базового значения перечисляются отдельно.
+Счёт детерминирован: от запуска к запуску на одном образе не меняется.
+"""
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+
+RE_BENCH = re.compile(r'^BENCH\s+(\S+)\s+(\d+)\s*$')
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description='Instruction counts of compute kernels under QEMU')
+    parser.add_argument('--qemu', default='qemu-system-arm', help='исполняемый файл QEMU')
+    parser.add_argument('--machine', default='mps2-an386', help='машина QEMU с Cortex-M4F')
+    parser.add_argument('--elf', required=True, help='образ замера')
+    parser.add_argument('--timeout', type=int, default=120, help='предел времени запуска, с')
+    parser.add_argument('--baseline', help='JSON с базовыми значениями для сравнения')
+    parser.add_argument('--threshold', type=float, default=2.0,
+                        help='допустимый рост ядра в процентах')
+    parser.add_argument('--write-baseline', help='сохранить текущие значения как базовые')
+    return parser.parse_args()
+
+
+def run(args):
+    """Запуск образа; возвращает код выхода и результаты по ядрам."""
+    command = [args.qemu, '-M', args.machine, '-nographic', '-monitor', 'none',
+               '-semihosting-config', 'enable=on,target=native',
+               '-icount', 'shift=0', '-kernel', args.elf]
+    process = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                             universal_newlines=True, timeout=args.timeout)
+    results = {}
+    for line in process.stdout.splitlines():
+        match = RE_BENCH.match(line)
+        if match:
+            results[match.group(1)] = int(match.group(2))
+        elif line.strip():
+            sys.stderr.write('qemu: %s\n' % line)
+    return process.returncode, results
+
+
+def check_regressions(current, baseline, threshold):
+    """Возвращает (рост выше порога, пропавшие ядра, ядра без базы)."""
+    regressions = []
+    for name, count in current.items():
+        old = baseline.get(name)
+        if old and 100.0 * (count - old) / old > threshold:
+            regressions.append((name, old, count))
+    missing = sorted(name for name in baseline if name not in current)
+    new = sorted(name for name in current if name not in baseline)
+    return regressions, missing, new
+
+
+def main():
+    args = parse_args()
+
+    if args.baseline and not os.path.exists(args.baseline):
+        sys.stderr.write('qemu_bench: baseline %s not found, run "make qemu_bench_baseline" first\n' % args.baseline)
+        return 2
+
+    returncode, current = run(args)
+    if not current:
+        sys.stderr.write('qemu_bench: no results from %s\n' % args.elf)
+        return 2
+
+    print('Instructions per call:')
+    for name in sorted(current):
+        print('  %-32s %10d' % (name, current[name]))
+
+    if returncode != 0:
+        sys.stderr.write('qemu_bench: kernel self-check failed (exit code %d)\n' % returncode)
+        return 2
+
+    if args.write_baseline:
+        with open(args.write_baseline, 'w') as f:
+            json.dump(current, f, indent=2, sort_keys=True)
+            f.write('\n')
+        print('')
+        print('Baseline written to %s' % args.write_baseline)
+
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        regressions, missing, new = check_regressions(current, baseline, args.threshold)
+        print('')
+        if new:
+            print('New kernels without baseline (run qemu_bench_baseline to record them):')
+            for name in new:
+                print('  %-32s %10d' % (name, current[name]))
+        if missing:
+            print('Kernels missing from the output:')
+            for name in missing:
+                print('  %-32s %10d -> (none)' % (name, baseline[name]))
+        if regressions:
+            print('Instruction count regressions (threshold %.1f%%):' % args.threshold)
+            for name, old, count in regressions:
+                print('  %-32s %10d -> %10d (+%.1f%%)' % (name, old, count, 100.0 * (count - old) / old))
+        if regressions or missing:
+            return 1
+        print('No instruction count regressions above %.1f%%' % args.threshold)
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
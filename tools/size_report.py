@@ -0,0 +1,284 @@
+#!/usr/bin/env python3
+"""
+Отчёт о занятости FLASH/RAM по map-файлу линкера.
+
+Разбирает map-файл GNU ld, распределяет размер входных секций по модулям
+(файлы проекта и модули SDK), печатает сводку по регионам памяти и самые
+крупные символы. При наличии базового файла сравнивает размеры модулей с ним
+и завершается с ненулевым кодом, если рост превышает порог.
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+from collections import defaultdict
+
+RE_REGION = re.compile(r'^(\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)')
+RE_OUT_SECTION = re.compile(r'^(\.?\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+load address\s+0x([0-9a-fA-F]+))?')
+RE_OUT_SECTION_NAME = re.compile(r'^(\.\S+)\s*$')
+RE_IN_SECTION = re.compile(r'^ (\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$')
+RE_IN_SECTION_NAME = re.compile(r'^ (\S+)\s*$')
+RE_IN_SECTION_CONT = re.compile(r'^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$')
+RE_LIB_MEMBER = re.compile(r'^(?:.*/)?(lib[^/()]+)\.a\(([^)]+)\)$')
+
+SYMBOL_PREFIXES = ('.text.', '.rodata.', '.data.', '.bss.', '.noinit.')
+
+
+class Region(object):
+    def __init__(self, name, origin, length):
+        self.name = name
+        self.origin = origin
+        self.length = length
+
+    def contains(self, address):
+        return self.origin <= address < self.origin + self.length
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description='FLASH/RAM budget report from a GNU ld map file')
+    parser.add_argument('--map', required=True, help='map-файл линкера')
+    parser.add_argument('--sdk-root', default='', help='корень nRF5 SDK (для имён модулей)')
+    parser.add_argument('--sources', nargs='*', default=[], help='исходники из SRC_FILES')
+    parser.add_argument('--top', type=int, default=20, help='количество крупнейших символов')
+    parser.add_argument('--baseline', help='JSON с базовыми размерами для сравнения')
+    parser.add_argument('--threshold', type=int, default=256,
+                        help='допустимый рост модуля/итога в байтах')
+    parser.add_argument('--write-baseline', help='сохранить текущие размеры как базовые')
+    return parser.parse_args()
+
+
+def source_module(path, sdk_root):
+    """Имя модуля для исходного файла: файлы проекта - по имени, SDK - по каталогу."""
+    path = os.path.normpath(path)
+    root = os.path.normpath(sdk_root) if sdk_root else ''
+    if root and (path == root or path.startswith(root + os.sep)):
+        rel = os.path.relpath(path, root)
+        directory, filename = os.path.split(rel)
+        parts = [p for p in directory.split(os.sep) if p not in ('src', 'prs')]
+        directory = '/'.join(parts)
+        # Драйверы nrfx и legacy-обёртки лежат в одном каталоге - считаем каждый отдельно
+        if '/drivers' in directory or directory.endswith('legacy'):
+            return directory + '/' + os.path.splitext(filename)[0]
+        return directory
+    return os.path.basename(path)
+
+
+def object_module(obj, object_map):
+    obj = obj.strip()
+    match = RE_LIB_MEMBER.match(obj)
+    if match:
+        return 'lib:' + match.group(1)
+    base = os.path.basename(obj)
+    if base in object_map:
+        return object_map[base]
+    if base.endswith('.o'):
+        return os.path.splitext(base)[0]
+    return base
+
+
+def parse_map(lines):
+    regions = []
+    sections = []   # (out_section, vma, lma, in_section, size, object)
+    state = 'head'
+    out_name = None
+    out_vma = 0
+    out_lma = None
+    pending_out = None
+    pending_in = None
+
+    for line in lines:
+        line = line.rstrip('\n')
+        if state == 'head':
+            if line.startswith('Memory Configuration'):
+                state = 'memory'
+            continue
+        if state == 'memory':
+            if line.startswith('Linker script and memory map'):
+                state = 'map'
+                continue
+            match = RE_REGION.match(line)
+            if match and match.group(1) not in ('Name', '*default*'):
+                regions.append(Region(match.group(1), int(match.group(2), 16), int(match.group(3), 16)))
+            continue
+
+        # Имя выходной секции может быть на отдельной строке
+        if pending_out is not None:
+            match = re.match(r'^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+load address\s+0x([0-9a-fA-F]+))?', line)
+            if match:
+                out_name = pending_out
+                out_vma = int(match.group(1), 16)
+                out_lma = int(match.group(3), 16) if match.group(3) else None
+            pending_out = None
+            continue
+
+        if pending_in is not None:
+            match = RE_IN_SECTION_CONT.match(line)
+            if match and out_name is not None:
+                sections.append((out_name, int(match.group(1), 16), out_lma, pending_in,
+                                 int(match.group(2), 16), match.group(3)))
+            pending_in = None
+            continue
+
+        if not line or line.startswith(('LOAD ', 'START GROUP', 'END GROUP', 'OUTPUT(')):
+            continue
+
+        if not line.startswith(' '):
+            match = RE_OUT_SECTION.match(line)
+            if match and match.group(1).startswith('.'):
+                out_name = match.group(1)
+                out_vma = int(match.group(2), 16)
+                out_lma = int(match.group(4), 16) if match.group(4) else None
+                continue
+            match = RE_OUT_SECTION_NAME.match(line)
+            if match:
+                pending_out = match.group(1)
+            continue
+
+        if out_name is None:
+            continue
+
+        if line.startswith(' *fill*'):
+            fields = line.split()
+            if len(fields) >= 3:
+                sections.append((out_name, int(fields[1], 16), out_lma, '*fill*', int(fields[2], 16), '(fill)'))
+            continue
+
+        match = RE_IN_SECTION.match(line)
+        if match:
+            sections.append((out_name, int(match.group(2), 16), out_lma, match.group(1),
+                             int(match.group(3), 16), match.group(4)))
+            continue
+        match = RE_IN_SECTION_NAME.match(line)
+        if match and match.group(1).startswith('.'):
+            pending_in = match.group(1)
+
+    return regions, sections
+
+
+def region_of(address, regions):
+    for region in regions:
+        if region.contains(address):
+            return region.name
+    return None
+
+
+def collect(regions, sections, object_map):
+    modules = defaultdict(lambda: defaultdict(int))
+    symbols = []
+    for out_name, vma, lma, in_name, size, obj in sections:
+        if size == 0:
+            continue
+        region = region_of(vma, regions)
+        if region is None:
+            continue
+        module = '(fill)' if obj == '(fill)' else object_module(obj, object_map)
+        modules[module][region] += size
+        # Инициализированные данные в RAM занимают место и во FLASH
+        if lma is not None and lma != vma:
+            load_region = region_of(lma, regions)
+            if load_region is not None and load_region != region:
+                modules[module][load_region] += size
+        for prefix in SYMBOL_PREFIXES:
+            if in_name.startswith(prefix):
+                symbols.append((size, in_name[len(prefix):], region, module))
+                break
+    return modules, symbols
+
+
+def print_report(regions, modules, symbols, top):
+    names = [r.name for r in regions]
+    totals = defaultdict(int)
+    for sizes in modules.values():
+        for name, size in sizes.items():
+            totals[name] += size
+
+    print('Memory regions:')
+    for region in regions:
+        used = totals.get(region.name, 0)
+        print('  %-8s %8d / %8d bytes (%5.1f%%)' % (region.name, used, region.length,
+                                                   100.0 * used / region.length if region.length else 0.0))
+
+    print('')
+    print('Per module:')
+    header = '  %-48s' % 'module' + ''.join('%10s' % n for n in names)
+    print(header)
+    order = sorted(modules.items(), key=lambda item: -sum(item[1].values()))
+    for module, sizes in order:
+        print('  %-48s' % module + ''.join('%10d' % sizes.get(n, 0) for n in names))
+
+    print('')
+    print('Largest symbols:')
+    for size, name, region, module in sorted(symbols, key=lambda s: -s[0])[:top]:
+        print('  %8d  %-6s %-40s %s' % (size, region, name, module))
+
+    return totals
+
+
+def to_json(modules, totals):
+    return {
+        'totals': dict(totals),
+        'modules': {module: dict(sizes) for module, sizes in modules.items()},
+    }
+
+
+def check_regressions(current, baseline, threshold):
+    regressions = []
+    for region, size in current['totals'].items():
+        old = baseline.get('totals', {}).get(region, 0)
+        if size - old > threshold:
+            regressions.append(('TOTAL', region, old, size))
+    for module, sizes in current['modules'].items():
+        for region, size in sizes.items():
+            old = baseline.get('modules', {}).get(module, {}).get(region, 0)
+            if size - old > threshold:
+                regressions.append((module, region, old, size))
+    return regressions
+
+
+def main():
+    args = parse_args()
+
+    if args.baseline and not os.path.exists(args.baseline):
+        sys.stderr.write('size_report: baseline %s not found, run "make size_baseline" first\n' % args.baseline)
+        return 2
+
+    object_map = {}
+    for src in args.sources:
+        object_map[os.path.basename(src) + '.o'] = source_module(src, args.sdk_root)
+
+    with open(args.map) as f:
+        regions, sections = parse_map(f)
+    if not regions:
+        sys.stderr.write('size_report: no memory configuration in %s\n' % args.map)
+        return 2
+
+    modules, symbols = collect(regions, sections, object_map)
+    totals = print_report(regions, modules, symbols, args.top)
+    current = to_json(modules, totals)
+
+    if args.write_baseline:
+        with open(args.write_baseline, 'w') as f:
+            json.dump(current, f, indent=2, sort_keys=True)
+            f.write('\n')
+        print('')
+        print('Baseline written to %s' % args.write_baseline)
+
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        regressions = check_regressions(current, baseline, args.threshold)
+        print('')
+        if regressions:
+            print('Size regressions (threshold %d bytes):' % args.threshold)
+            for module, region, old, new in regressions:
+                print('  %-48s %-6s %8d -> %8d (+%d)' % (module, region, old, new, new - old))
+            return 1
+        print('No size regressions above %d bytes' % args.threshold)
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,397 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "nrf.h"
+#include "app_error.h"
+#include "app_util.h"
+#include "app_usbd.h"
+#include "app_usbd_cdc_acm.h"
+#include "app_usbd_serial_num.h"
+#include "color_calib.h"
+#include "wdt_supervisor.h"
+#include "mem_monitor.h"
+#include "power_monitor.h"
+#include "boot_timing.h"
+#include "usb_cli.h"
+
+#define CDC_ACM_COMM_INTERFACE  0
+#define CDC_ACM_COMM_EPIN       NRF_DRV_USBD_EPIN2
+#define CDC_ACM_DATA_INTERFACE  1
+#define CDC_ACM_DATA_EPIN       NRF_DRV_USBD_EPIN1
+#define CDC_ACM_DATA_EPOUT      NRF_DRV_USBD_EPOUT1
+
+#define USB_CLI_LINE_MAX        96      /**< Длина командной строки */
+#define USB_CLI_ARGS_MAX        12      /**< Слов в командной строке */
+#define USB_CLI_REPLY_MAX       256     /**< Длина ответа на команду (самый длинный - power) */
+
+/**
+ * @brief Команда интерфейса
+ */
+typedef struct {
+    const char * name;
+    void (*handler)(int argc, char ** argv);    /**< argv[0] - имя команды */
+} usb_cli_cmd_t;
+
+static void cdc_acm_user_ev_handler(app_usbd_class_inst_t const * p_inst, app_usbd_cdc_acm_user_event_t event);
+
+APP_USBD_CDC_ACM_GLOBAL_DEF(m_cdc_acm,
+                            cdc_acm_user_ev_handler,
+                            CDC_ACM_COMM_INTERFACE,
+                            CDC_ACM_DATA_INTERFACE,
+                            CDC_ACM_COMM_EPIN,
+                            CDC_ACM_DATA_EPIN,
+                            CDC_ACM_DATA_EPOUT,
+                            APP_USBD_CDC_COMM_PROTOCOL_NONE);
+
+static char m_rx_byte;                          /**< Приём по одному байту */
+static char m_line[USB_CLI_LINE_MAX];           /**< Накопленная строка */
+static size_t m_line_length;
+static bool m_line_overflow;                    /**< Строка длиннее буфера - отбрасывается целиком */
+
+static char m_reply[USB_CLI_REPLY_MAX];         /**< Ответ; буфер занят до TX_DONE */
+static size_t m_reply_length;
+static bool m_reply_busy;
+
+/**
+ * @brief Добавляет текст к ответу (лишнее отбрасывается)
+ */
+static void reply_printf(const char * p_format, ...) {
+    va_list args;
+
+    va_start(args, p_format);
+    int length = vsnprintf(m_reply + m_reply_length, sizeof(m_reply) - m_reply_length, p_format, args);
+    va_end(args);
+
+    if (length > 0) {
+        m_reply_length += MIN((size_t)length, sizeof(m_reply) - 1 - m_reply_length);
+    }
+}
+
+/**
+ * @brief Разбор целого числа в диапазоне
+ */
+static bool parse_int(const char * p_text, long min, long max, long * p_value) {
+    char * p_end;
+    long value = strtol(p_text, &p_end, 0);
+
+    if (p_end == p_text || *p_end != '\0' || value < min || value > max) {
+        return false;
+    }
+    *p_value = value;
+    return true;
+}
+
+static void calib_print(void) {
+    color_calib_t calib;
+    color_calib_get(&calib);
+
+    reply_printf("matrix");
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            reply_printf(" %d", calib.matrix[i][j]);
+        }
+    }
+    reply_printf("\r\nmax %u %u %u\r\n", calib.max_level[0], calib.max_level[1], calib.max_level[2]);
+}
+
+/**
+ * @brief calib [matrix m00..m22 | max r g b | reset | load | save]
+ */
+static void cmd_calib(int argc, char ** argv) {
+    color_calib_t calib;
+    ret_code_t err_code = NRF_SUCCESS;
+    long value;
+
+    color_calib_get(&calib);
+
+    if (argc == 1) {
+        calib_print();
+    } else if (strcmp(argv[1], "matrix") == 0 && argc == 2 + 9) {
+        for (int k = 0; k < 9; k++) {
+            if (!parse_int(argv[2 + k], INT16_MIN, INT16_MAX, &value)) {
+                reply_printf("ERROR bad coefficient\r\n");
+                return;
+            }
+            calib.matrix[k / 3][k % 3] = (int16_t)value;
+        }
+        err_code = color_calib_set(&calib);
+    } else if (strcmp(argv[1], "max") == 0 && argc == 2 + 3) {
+        for (int i = 0; i < 3; i++) {
+            if (!parse_int(argv[2 + i], 0, COLOR_MODEL_LEVEL_MAX, &value)) {
+                reply_printf("ERROR bad level\r\n");
+                return;
+            }
+            calib.max_level[i] = (uint16_t)value;
+        }
+        err_code = color_calib_set(&calib);
+    } else if (strcmp(argv[1], "reset") == 0 && argc == 2) {
+        color_calib_default_get(&calib);
+        err_code = color_calib_set(&calib);
+    } else if (strcmp(argv[1], "load") == 0 && argc == 2) {
+        err_code = color_calib_load();
+    } else if (strcmp(argv[1], "save") == 0 && argc == 2) {
+        err_code = color_calib_save();
+    } else {
+        reply_printf("ERROR usage: calib [matrix m00..m22 | max r g b | reset | load | save]\r\n");
+        return;
+    }
+
+    if (err_code == NRF_SUCCESS) {
+        reply_printf("OK\r\n");
+    } else {
+        reply_printf("ERROR %u\r\n", (unsigned)err_code);
+    }
+}
+
+/**
+ * @brief reset - причина предыдущего сброса
+ */
+static void cmd_reset(int argc, char ** argv) {
+    (void)argv;
+    wdt_supervisor_report_t report;
+
+    if (argc != 1) {
+        reply_printf("ERROR usage: reset\r\n");
+        return;
+    }
+
+    wdt_supervisor_report_get(&report);
+    reply_printf("resetreas 0x%08lx watchdog %u missing 0x%08lx\r\n",
+                 (unsigned long)report.resetreas, report.watchdog, (unsigned long)report.missing_tasks);
+    if (report.snapshot_valid) {
+        reply_printf("tick %lu snapshot", (unsigned long)report.tick);
+        for (int i = 0; i < WDT_SUPERVISOR_SNAPSHOT_SIZE; i++) {
+            reply_printf("%s%02x", (i % 4) ? "" : " ", report.snapshot[i]);
+        }
+        reply_printf("\r\n");
+    }
+    reply_printf("OK\r\n");
+}
+
+/**
+ * @brief mem - глубина стека с момента запуска и использование кучи
+ */
+static void cmd_mem(int argc, char ** argv) {
+    (void)argv;
+    mem_monitor_heap_t heap;
+
+    if (argc != 1) {
+        reply_printf("ERROR usage: mem\r\n");
+        return;
+    }
+
+    mem_monitor_heap_get(&heap);
+    reply_printf("stack %lu watermark %lu isr %lu\r\n",
+                 (unsigned long)mem_monitor_stack_size(),
+                 (unsigned long)mem_monitor_stack_high_watermark(),
+                 (unsigned long)mem_monitor_isr_stack_high_watermark());
+    reply_printf("heap %lu peak %lu used %lu free %lu\r\nOK\r\n",
+                 (unsigned long)heap.capacity, (unsigned long)heap.arena,
+                 (unsigned long)heap.in_use, (unsigned long)heap.free);
+}
+
+/**
+ * @brief power - время сна и активности по причинам с момента запуска, мс
+ */
+static void cmd_power(int argc, char ** argv) {
+    (void)argv;
+    power_monitor_stats_t stats;
+
+    if (argc != 1) {
+        reply_printf("ERROR usage: power\r\n");
+        return;
+    }
+
+    // nano printf не печатает 64-битные числа: миллисекунды в 32 битах хватает на 49 суток
+    power_monitor_stats_get(&stats);
+    reply_printf("wall %lu sleep %lu wakeups %lu cpu %u%%\r\n",
+                 (unsigned long)(stats.wall_us / 1000), (unsigned long)(stats.sleep_us / 1000),
+                 (unsigned long)stats.wakeups, stats.cpu_usage_max);
+    reply_printf("main %lu timer %lu gpiote %lu pwm %lu\r\n",
+                 (unsigned long)(stats.active_us[POWER_MONITOR_CAUSE_MAIN] / 1000),
+                 (unsigned long)(stats.active_us[POWER_MONITOR_CAUSE_TIMER] / 1000),
+                 (unsigned long)(stats.active_us[POWER_MONITOR_CAUSE_GPIOTE] / 1000),
+                 (unsigned long)(stats.active_us[POWER_MONITOR_CAUSE_PWM] / 1000));
+    reply_printf("pwm running %lu static %lu current %lu saved %lu uC\r\nOK\r\n",
+                 (unsigned long)(stats.pwm_running_us / 1000), (unsigned long)(stats.pwm_static_us / 1000),
+                 (unsigned long)stats.pwm_current_ua, (unsigned long)stats.pwm_saved_uc);
+}
+
+/**
+ * @brief boot - время этапов запуска от входа в main(), мкс
+ */
+static void cmd_boot(int argc, char ** argv) {
+    (void)argv;
+    boot_timing_t timing;
+
+    if (argc != 1) {
+        reply_printf("ERROR usage: boot\r\n");
+        return;
+    }
+
+    boot_timing_get(&timing);
+    reply_printf("clocks %lu first_light %lu lfclk %lu us\r\nOK\r\n",
+                 (unsigned long)timing.us[BOOT_TIMING_CLOCKS],
+                 (unsigned long)timing.us[BOOT_TIMING_FIRST_LIGHT],
+                 (unsigned long)timing.us[BOOT_TIMING_LFCLK]);
+}
+
+static const usb_cli_cmd_t m_commands[] = {
+    { "calib", cmd_calib },
+    { "reset", cmd_reset },
+    { "mem",   cmd_mem },
+    { "power", cmd_power },
+    { "boot",  cmd_boot },
+};
+
+/**
+ * @brief Разбивает строку на слова и выполняет команду
+ */
+static void line_execute(char * p_line) {
+    char * argv[USB_CLI_ARGS_MAX];
+    int argc = 0;
+
+    for (char * p_word = strtok(p_line, " \t"); p_word != NULL; p_word = strtok(NULL, " \t")) {
+        if (argc == USB_CLI_ARGS_MAX) {
+            reply_printf("ERROR too many arguments\r\n");
+            return;
+        }
+        argv[argc++] = p_word;
+    }
+    if (argc == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < ARRAY_SIZE(m_commands); i++) {
+        if (strcmp(argv[0], m_commands[i].name) == 0) {
+            m_commands[i].handler(argc, argv);
+            return;
+        }
+    }
+    reply_printf("ERROR unknown command\r\n");
+}
+
+/**
+ * @brief Накопление строки и выполнение команды по CR/LF
+ */
+static void rx_byte_process(char byte) {
+    if (byte != '\r' && byte != '\n') {
+        if (m_line_length < sizeof(m_line) - 1) {
+            m_line[m_line_length++] = byte;
+        } else {
+            m_line_overflow = true;
+        }
+        return;
+    }
+
+    m_line[m_line_length] = '\0';
+
+    // Пока предыдущий ответ не передан, новая команда не выполняется
+    if (m_reply_busy) {
+        m_line_length = 0;
+        m_line_overflow = false;
+        return;
+    }
+
+    m_reply_length = 0;
+    if (m_line_overflow) {
+        reply_printf("ERROR line too long\r\n");
+    } else {
+        line_execute(m_line);
+    }
+    m_line_length = 0;
+    m_line_overflow = false;
+
+    if (m_reply_length > 0
+        && app_usbd_cdc_acm_write(&m_cdc_acm, m_reply, m_reply_length) == NRF_SUCCESS) {
+        m_reply_busy = true;
+    }
+}
+
+static void cdc_acm_user_ev_handler(app_usbd_class_inst_t const * p_inst, app_usbd_cdc_acm_user_event_t event) {
+    app_usbd_cdc_acm_t const * p_cdc_acm = app_usbd_cdc_acm_class_get(p_inst);
+
+    switch (event) {
+        case APP_USBD_CDC_ACM_USER_EVT_PORT_OPEN:
+            m_line_length = 0;
+            m_line_overflow = false;
+            m_reply_busy = false;
+            app_usbd_cdc_acm_read(p_cdc_acm, &m_rx_byte, 1);
+            break;
+
+        case APP_USBD_CDC_ACM_USER_EVT_PORT_CLOSE:
+            m_reply_busy = false;
+            break;
+
+        case APP_USBD_CDC_ACM_USER_EVT_TX_DONE:
+            m_reply_busy = false;
+            break;
+
+        case APP_USBD_CDC_ACM_USER_EVT_RX_DONE:
+            // Байты, уже лежащие в буфере класса, читаются без ожидания события
+            do {
+                if (app_usbd_cdc_acm_rx_size(p_cdc_acm) > 0) {
+                    rx_byte_process(m_rx_byte);
+                }
+            } while (app_usbd_cdc_acm_read(p_cdc_acm, &m_rx_byte, 1) == NRF_SUCCESS);
+            break;
+
+        default:
+            break;
+    }
+}
+
+static void usbd_user_ev_handler(app_usbd_event_type_t event) {
+    switch (event) {
+        case APP_USBD_EVT_STOPPED:
+            app_usbd_disable();
+            break;
+
+        case APP_USBD_EVT_POWER_DETECTED:
+            if (!nrfx_usbd_is_enabled()) {
+                app_usbd_enable();
+            }
+            break;
+
+        case APP_USBD_EVT_POWER_REMOVED:
+            app_usbd_stop();
+            break;
+
+        case APP_USBD_EVT_POWER_READY:
+            app_usbd_start();
+            break;
+
+        default:
+            break;
+    }
+}
+
+void usb_cli_init(void) {
+    static const app_usbd_config_t usbd_config = {
+        .ev_state_proc = usbd_user_ev_handler
+    };
+
+    app_usbd_serial_num_generate();
+
+    APP_ERROR_CHECK(app_usbd_init(&usbd_config));
+    APP_ERROR_CHECK(app_usbd_class_append(app_usbd_cdc_acm_class_inst_get(&m_cdc_acm)));
+
+    // Подключение и отключение кабеля - по событиям POWER (VBUS)
+    APP_ERROR_CHECK(app_usbd_power_events_enable());
+}
+
+bool usb_cli_process(void) {
+    return app_usbd_event_queue_process();
+}
+
+void usb_cli_uninit(void) {
+    if (nrfx_usbd_is_started()) {
+        app_usbd_stop();
+        while (app_usbd_event_queue_process()) {
+        }
+    }
+    if (nrfx_usbd_is_enabled()) {
+        app_usbd_disable();
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef USB_CLI_H__
+#define USB_CLI_H__
+
+#include <stdbool.h>
+
+#ifndef USB_CLI_ENABLED
+#define USB_CLI_ENABLED     1       /**< Командный интерфейс через USB CDC ACM */
+#endif
+
+/**
+ * @brief Запускает USB CDC ACM с командным интерфейсом
+ *
+ * Команды - строки, завершённые CR или LF, ответ - строки "OK" или
+ * "ERROR <причина>" после данных команды:
+ *   calib                          - текущая калибровка
+ *   calib matrix m00 m01 ... m22   - матрица Q12 по строкам R, G, B (4096 = 1.0)
+ *   calib max r g b                - предельные уровни Q15 (32767 = 100%)
+ *   calib reset                    - единичная матрица, 100%
+ *   calib load                     - перечитать калибровку из flash
+ *   calib save                     - записать калибровку во flash
+ *   reset                          - причина предыдущего сброса и снимок последнего тика
+ *   mem                            - размер стека и его наибольшая глубина (всего и в прерываниях),
+ *                                    размер кучи, её пик, занятое и свободное в арене
+ *   power                          - время с запуска, сон, пробуждения, пик загрузки CPU и
+ *                                    активное время по причинам (основной цикл, таймер, GPIOTE, PWM), мс
+ *                                    время с запущенным и остановленным PWM, мс, ток PWM и HFCLK, мкА,
+ *                                    и сэкономленный остановкой PWM заряд, мкКл
+ *   boot                           - время этапов запуска от входа в main(): часы, первый свет,
+ *                                    LFCLK, мкс (время до main() - осциллографом по BOOT_TIMING_PIN)
+ *
+ * Изменения применяются сразу и сохраняются только по "calib save".
+ * HFXO для USB запрашивается библиотекой app_usbd через nrf_drv_clock,
+ * поэтому вызывается после power_profile_init().
+ */
+void usb_cli_init(void);
+
+/**
+ * @brief Обрабатывает события USB и выполняет принятые команды
+ *
+ * Вызывается из основного цикла: команды (в том числе запись flash)
+ * выполняются вне прерываний.
+ *
+ * @return true - обработано событие, в очереди могут быть ещё
+ */
+bool usb_cli_process(void);
+
+/**
+ * @brief Останавливает USB перед System OFF
+ */
+void usb_cli_uninit(void);
+
+#endif // USB_CLI_H__
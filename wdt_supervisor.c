@@ -0,0 +1,128 @@
+#include <string.h>
+#include "nrf.h"
+#include "sdk_config.h"
+#include "app_error.h"
+#include "nrf_atomic.h"
+#include "nrfx_wdt.h"
+#include "wdt_supervisor.h"
+
+#define NOINIT_MAGIC            0x3D06F00DUL    /**< Признак снимка тика */
+#define NOINIT_WDT_MAGIC        0x3D06DEADUL    /**< Признак сохранения при срабатывании WDT */
+
+/**
+ * @brief Данные, переживающие сброс
+ *
+ * Снимок пишется каждый тик; счётчики begin/end совпадают, только если
+ * запись не прервана сбросом.
+ */
+typedef struct {
+    uint32_t magic;
+    volatile uint32_t begin;
+    uint32_t tick;
+    uint32_t size;
+    uint8_t  data[WDT_SUPERVISOR_SNAPSHOT_SIZE];
+    volatile uint32_t end;
+    uint32_t wdt_magic;         /**< NOINIT_WDT_MAGIC - сохранено обработчиком WDT */
+    uint32_t missing_tasks;
+} noinit_t;
+
+static noinit_t m_noinit __attribute__((section(".noinit")));   /**< Не обнуляется при старте */
+
+static wdt_supervisor_report_t m_report;    /**< Причина предыдущего сброса */
+static nrfx_wdt_channel_id m_channel;       /**< Канал перезагрузки WDT */
+static uint32_t m_tasks;                    /**< Маска зарегистрированных задач */
+static nrf_atomic_u32_t m_checked;          /**< Маска отметившихся задач за период */
+static volatile bool m_started;             /**< WDT запущен, его можно кормить */
+
+/**
+ * @brief Срабатывание WDT: до сброса остаётся два такта LFCLK (~61 мкс)
+ */
+static void wdt_event_handler(void) {
+    m_noinit.missing_tasks = m_tasks & ~m_checked;
+    m_noinit.wdt_magic = NOINIT_WDT_MAGIC;
+}
+
+/**
+ * @brief Разбор .noinit и RESETREAS, оставшихся от предыдущего запуска
+ */
+static void report_capture(void) {
+    uint32_t resetreas = NRF_POWER->RESETREAS;
+
+    memset(&m_report, 0, sizeof(m_report));
+    m_report.resetreas = resetreas;
+    m_report.watchdog = (resetreas & POWER_RESETREAS_DOG_Msk) != 0;
+
+    // После включения питания RAM случайна: RESETREAS в этом случае пуст
+    if (resetreas != 0 && m_noinit.magic == NOINIT_MAGIC && m_noinit.begin == m_noinit.end
+        && m_noinit.size <= WDT_SUPERVISOR_SNAPSHOT_SIZE) {
+        m_report.snapshot_valid = true;
+        m_report.tick = m_noinit.tick;
+        memcpy(m_report.snapshot, m_noinit.data, m_noinit.size);
+    }
+    if (m_report.watchdog && m_noinit.wdt_magic == NOINIT_WDT_MAGIC) {
+        m_report.missing_tasks = m_noinit.missing_tasks;
+    }
+
+    // Признак выхода из System OFF читает и очищает system_off_restore()
+    NRF_POWER->RESETREAS = resetreas & ~POWER_RESETREAS_OFF_Msk;
+
+    memset(&m_noinit, 0, sizeof(m_noinit));
+    m_noinit.magic = NOINIT_MAGIC;
+}
+
+void wdt_supervisor_init(void) {
+    report_capture();
+
+    nrfx_wdt_config_t config = {
+        .behaviour = (nrf_wdt_behaviour_t)NRFX_WDT_CONFIG_BEHAVIOUR,
+        .reload_value = WDT_SUPERVISOR_RELOAD_MS,
+        .interrupt_priority = WDT_SUPERVISOR_IRQ_PRIORITY
+    };
+    APP_ERROR_CHECK(nrfx_wdt_init(&config, wdt_event_handler));
+    APP_ERROR_CHECK(nrfx_wdt_channel_alloc(&m_channel));
+}
+
+void wdt_supervisor_start(void) {
+    nrf_atomic_u32_and(&m_checked, 0);
+    nrfx_wdt_enable();
+    m_started = true;
+}
+
+ret_code_t wdt_supervisor_task_add(wdt_supervisor_task_t * p_task) {
+    for (uint32_t i = 0; i < WDT_SUPERVISOR_TASKS_MAX; i++) {
+        if (!(m_tasks & (1UL << i))) {
+            m_tasks |= 1UL << i;
+            *p_task = (wdt_supervisor_task_t)i;
+            return NRF_SUCCESS;
+        }
+    }
+    return NRF_ERROR_NO_MEM;
+}
+
+void wdt_supervisor_checkin(wdt_supervisor_task_t task) {
+    uint32_t checked = nrf_atomic_u32_or(&m_checked, 1UL << task);
+
+    if (m_started && (checked & m_tasks) == m_tasks) {
+        // Отметка, успевшая между проверкой и сбросом маски, засчитается в следующий период
+        nrf_atomic_u32_and(&m_checked, 0);
+        nrfx_wdt_channel_feed(m_channel);
+    }
+}
+
+void wdt_supervisor_snapshot(void const * p_data, size_t size) {
+    if (size > WDT_SUPERVISOR_SNAPSHOT_SIZE) {
+        size = WDT_SUPERVISOR_SNAPSHOT_SIZE;
+    }
+
+    m_noinit.begin++;
+    __DMB();
+    m_noinit.tick++;
+    m_noinit.size = size;
+    memcpy(m_noinit.data, p_data, size);
+    __DMB();
+    m_noinit.end = m_noinit.begin;
+}
+
+void wdt_supervisor_report_get(wdt_supervisor_report_t * p_report) {
+    *p_report = m_report;
+}
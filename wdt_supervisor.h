@@ -0,0 +1,78 @@
+#ifndef WDT_SUPERVISOR_H__
+#define WDT_SUPERVISOR_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "sdk_errors.h"
+
+#ifndef WDT_SUPERVISOR_RELOAD_MS
+#define WDT_SUPERVISOR_RELOAD_MS    NRFX_WDT_CONFIG_RELOAD_VALUE    /**< Период WDT */
+#endif
+
+#ifndef WDT_SUPERVISOR_IRQ_PRIORITY
+#define WDT_SUPERVISOR_IRQ_PRIORITY 2   /**< Выше обработчиков приложения: сохранение успевает и при зависшем тике */
+#endif
+
+#define WDT_SUPERVISOR_TASKS_MAX        32  /**< Задач - по разрядам маски */
+#define WDT_SUPERVISOR_SNAPSHOT_SIZE    32  /**< Размер снимка последнего тика в байтах */
+
+typedef uint8_t wdt_supervisor_task_t;  /**< Дескриптор задачи */
+
+/**
+ * @brief Причина предыдущего сброса и последний тик перед ним
+ */
+typedef struct {
+    uint32_t resetreas;         /**< NRF_POWER->RESETREAS при запуске, 0 - включение питания */
+    bool     watchdog;          /**< Сброс по WDT */
+    uint32_t missing_tasks;     /**< Маска задач, не отметившихся перед сбросом по WDT */
+    bool     snapshot_valid;    /**< Снимок ниже действителен */
+    uint32_t tick;              /**< Номер последнего тика */
+    uint8_t  snapshot[WDT_SUPERVISOR_SNAPSHOT_SIZE];    /**< Снимок последнего тика */
+} wdt_supervisor_report_t;
+
+/**
+ * @brief Запоминает причину сброса и настраивает WDT, не запуская его
+ *
+ * Вызывается до system_off_restore(): RESETREAS очищается полностью,
+ * кроме признака выхода из System OFF, который очищает system_off.
+ */
+void wdt_supervisor_init(void);
+
+/**
+ * @brief Запускает WDT
+ *
+ * Работающий WDT держит LFCLK включённым, и остановка LFCLK при смене
+ * источника (power_profile_lfclk_migrate) ждала бы бесконечно - поэтому
+ * WDT запускается после перехода. Отметки задач до запуска только
+ * собираются.
+ */
+void wdt_supervisor_start(void);
+
+/**
+ * @brief Регистрирует задачу, которая должна отмечаться каждый период WDT
+ * @param p_task Дескриптор для wdt_supervisor_checkin()
+ * @return NRF_SUCCESS или NRF_ERROR_NO_MEM
+ */
+ret_code_t wdt_supervisor_task_add(wdt_supervisor_task_t * p_task);
+
+/**
+ * @brief Отметка задачи; WDT кормится, когда отметились все задачи
+ *
+ * Можно вызывать из любого контекста.
+ */
+void wdt_supervisor_checkin(wdt_supervisor_task_t task);
+
+/**
+ * @brief Сохраняет снимок тика в .noinit (переживает сброс, кроме выключения питания)
+ * @param p_data Данные
+ * @param size Размер (не больше WDT_SUPERVISOR_SNAPSHOT_SIZE)
+ */
+void wdt_supervisor_snapshot(void const * p_data, size_t size);
+
+/**
+ * @brief Причина предыдущего сброса
+ */
+void wdt_supervisor_report_get(wdt_supervisor_report_t * p_report);
+
+#endif // WDT_SUPERVISOR_H__
@@ -0,0 +1,169 @@
+#include <string.h>
+#include "nrf.h"
+#include "sdk_config.h"
+#include "nrf_gpio.h"
+#include "nrfx_pwm.h"
+#include "app_util.h"
+#include "app_util_platform.h"
+#include "app_error.h"
+#include "cycle_counter.h"
+#include "ws2812.h"
+
+#if WS2812_ENABLED
+
+/* Бит кодируется одним периодом PWM 16 МГц / 20. Бит 15 значения: период
+ * начинается с высокого уровня, который длится value тактов */
+#define WS2812_PWM_TOP      20                  /**< 1.25 мкс */
+#define WS2812_T0H          (0x8000 | 6)        /**< 0: 0.375 мкс высокий уровень */
+#define WS2812_T1H          (0x8000 | 13)       /**< 1: 0.8125 мкс высокий уровень */
+#define WS2812_RESET_SLOTS  ((WS2812_RESET_US * 1000 + WS2812_BIT_NS - 1) / WS2812_BIT_NS)  /**< Периоды с низким уровнем */
+#define WS2812_BUFFER_SLOTS (WS2812_PIXELS_MAX * 32 + WS2812_RESET_SLOTS)   /**< Слотов на кадр (RGBW) */
+
+STATIC_ASSERT(WS2812_BUFFER_SLOTS <= 0x7FFF, "PWM sequence length is limited to 15 bits");
+
+static nrfx_pwm_t m_pwm = NRFX_PWM_INSTANCE(WS2812_PWM_INSTANCE);  /**< Экземпляр PWM ленты */
+static uint16_t m_buffers[2][WS2812_BUFFER_SLOTS];  /**< Двойной буфер закодированных кадров */
+static uint8_t  m_back = 0;             /**< Буфер для кодирования следующего кадра */
+static uint16_t m_frame_slots;          /**< Длина кадра в слотах */
+static uint16_t m_pixel_count;          /**< Количество пикселей */
+static uint32_t m_pin;                  /**< Пин данных */
+static ws2812_type_t m_type;            /**< Тип ленты */
+static volatile bool m_busy = false;    /**< Идёт передача */
+static volatile bool m_pending = false; /**< В заднем буфере ждёт готовый кадр */
+static uint32_t m_encode_cycles;        /**< Такты на кодирование последнего кадра */
+
+/* Четыре бита данных -> четыре слота PWM, старший бит первым */
+#define NIBBLE(n) { ((n) & 8) ? WS2812_T1H : WS2812_T0H, ((n) & 4) ? WS2812_T1H : WS2812_T0H, \
+                    ((n) & 2) ? WS2812_T1H : WS2812_T0H, ((n) & 1) ? WS2812_T1H : WS2812_T0H }
+static const uint16_t m_nibbles[16][4] = {
+    NIBBLE(0),  NIBBLE(1),  NIBBLE(2),  NIBBLE(3),  NIBBLE(4),  NIBBLE(5),  NIBBLE(6),  NIBBLE(7),
+    NIBBLE(8),  NIBBLE(9),  NIBBLE(10), NIBBLE(11), NIBBLE(12), NIBBLE(13), NIBBLE(14), NIBBLE(15),
+};
+
+/**
+ * @brief Запуск однократной передачи буфера
+ */
+static void transfer_start(uint8_t index) {
+    nrf_pwm_sequence_t sequence = {
+        .values.p_common = m_buffers[index],
+        .length = m_frame_slots,
+        .repeats = 0,
+        .end_delay = 0
+    };
+    m_busy = true;
+    nrfx_pwm_simple_playback(&m_pwm, &sequence, 1, NRFX_PWM_FLAG_STOP);
+}
+
+/**
+ * @brief Окончание передачи: запуск кадра из очереди
+ */
+static void pwm_event_handler(nrfx_pwm_evt_type_t event_type) {
+    if (event_type != NRFX_PWM_EVT_FINISHED) {
+        return;
+    }
+
+    if (m_pending) {
+        m_pending = false;
+        transfer_start(m_back);
+        m_back ^= 1;
+    } else {
+        m_busy = false;
+    }
+}
+
+/**
+ * @brief Кодирование байта в восемь слотов
+ */
+static inline uint16_t * encode_byte(uint16_t * p_out, uint8_t value) {
+    memcpy(p_out, m_nibbles[value >> 4], sizeof(m_nibbles[0]));
+    memcpy(p_out + 4, m_nibbles[value & 0x0F], sizeof(m_nibbles[0]));
+    return p_out + 8;
+}
+
+ret_code_t ws2812_init(uint32_t pin, ws2812_type_t type, uint16_t pixel_count) {
+    if (pixel_count == 0 || pixel_count > WS2812_PIXELS_MAX) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    m_pin = pin;
+    m_type = type;
+    m_pixel_count = pixel_count;
+    m_frame_slots = (uint16_t)(pixel_count * type * 8 + WS2812_RESET_SLOTS);
+
+    // Хвост сброса одинаков для обоих буферов: значение 0x8000 - весь период низкий уровень
+    for (uint32_t i = 0; i < 2; i++) {
+        for (uint32_t k = m_frame_slots - WS2812_RESET_SLOTS; k < m_frame_slots; k++) {
+            m_buffers[i][k] = 0x8000;
+        }
+    }
+
+    // Пин в покое - низкий уровень (nrfx_pwm_init оставляет OUT = 0)
+    nrfx_pwm_config_t pwm_config = NRFX_PWM_DEFAULT_CONFIG;
+    pwm_config.output_pins[0] = (uint8_t)pin;
+    pwm_config.output_pins[1] = NRFX_PWM_PIN_NOT_USED;
+    pwm_config.output_pins[2] = NRFX_PWM_PIN_NOT_USED;
+    pwm_config.output_pins[3] = NRFX_PWM_PIN_NOT_USED;
+    pwm_config.base_clock = NRF_PWM_CLK_16MHz;
+    pwm_config.count_mode = NRF_PWM_MODE_UP;
+    pwm_config.top_value  = WS2812_PWM_TOP;
+    pwm_config.load_mode  = NRF_PWM_LOAD_COMMON;
+    pwm_config.step_mode  = NRF_PWM_STEP_AUTO;
+
+    APP_ERROR_CHECK(nrfx_pwm_init(&m_pwm, &pwm_config, pwm_event_handler));
+
+    cycle_counter_init();
+    return NRF_SUCCESS;
+}
+
+void ws2812_show(ws2812_pixel_t const * p_pixels) {
+    uint32_t start = cycle_counter_get();
+
+    // Задний буфер может ждать запуска в обработчике - снимаем его с очереди
+    CRITICAL_REGION_ENTER();
+    m_pending = false;
+    CRITICAL_REGION_EXIT();
+
+    uint16_t * p_out = m_buffers[m_back];
+    for (uint16_t i = 0; i < m_pixel_count; i++) {
+        p_out = encode_byte(p_out, p_pixels[i].g);
+        p_out = encode_byte(p_out, p_pixels[i].r);
+        p_out = encode_byte(p_out, p_pixels[i].b);
+        if (m_type == WS2812_TYPE_GRBW) {
+            p_out = encode_byte(p_out, p_pixels[i].w);
+        }
+    }
+
+    m_encode_cycles = cycle_counter_get() - start;
+
+    CRITICAL_REGION_ENTER();
+    if (m_busy) {
+        m_pending = true;
+    } else {
+        transfer_start(m_back);
+        m_back ^= 1;
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+void ws2812_uninit(void) {
+    nrfx_pwm_stop(&m_pwm, true);
+    nrfx_pwm_uninit(&m_pwm);
+    m_busy = false;
+    m_pending = false;
+    nrf_gpio_cfg_default(m_pin);
+}
+
+bool ws2812_is_busy(void) {
+    return m_busy;
+}
+
+uint32_t ws2812_encode_time_us(void) {
+    return (uint32_t)cycle_counter_to_us(m_encode_cycles);
+}
+
+#endif // WS2812_ENABLED
+
+uint32_t ws2812_max_fps(ws2812_type_t type, uint16_t pixel_count) {
+    uint64_t frame_ns = (uint64_t)pixel_count * type * 8 * WS2812_BIT_NS + WS2812_RESET_US * 1000ULL;
+    return (uint32_t)(1000000000ULL / frame_ns);
+}
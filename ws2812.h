@@ -0,0 +1,101 @@
+#ifndef WS2812_H__
+#define WS2812_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sdk_errors.h"
+
+#ifndef WS2812_ENABLED
+#define WS2812_ENABLED      0       /**< Вывод на адресную ленту */
+#endif
+
+#define WS2812_PWM_INSTANCE 3       /**< Экземпляр PWM, занятый лентой (led_pwm его не использует) */
+
+#ifndef WS2812_PIXELS_MAX
+#define WS2812_PIXELS_MAX   144     /**< Максимальная длина ленты, пикселей */
+#endif
+
+#define WS2812_BIT_NS       1250    /**< Длительность бита: 20 тактов по 16 МГц */
+#define WS2812_RESET_US     300     /**< Пауза сброса (WS2812B новых ревизий требует > 280 мкс) */
+
+/**
+ * @brief Тип ленты: порядок и количество байт на пиксель
+ */
+typedef enum {
+    WS2812_TYPE_GRB = 3,    /**< WS2812/WS2812B: G, R, B */
+    WS2812_TYPE_GRBW = 4    /**< SK6812 RGBW: G, R, B, W */
+} ws2812_type_t;
+
+/**
+ * @brief Цвет пикселя, 8 бит на канал
+ */
+typedef struct {
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+    uint8_t w;  /**< Белый канал (только WS2812_TYPE_GRBW) */
+} ws2812_pixel_t;
+
+/**
+ * @brief Инициализация вывода на ленту
+ * @param pin Пин данных
+ * @param type Тип ленты
+ * @param pixel_count Количество пикселей (не более WS2812_PIXELS_MAX)
+ * @return NRF_SUCCESS или NRF_ERROR_INVALID_PARAM
+ */
+ret_code_t ws2812_init(uint32_t pin, ws2812_type_t type, uint16_t pixel_count);
+
+/**
+ * @brief Кодирует кадр и ставит его в очередь на вывод
+ *
+ * Кадр кодируется в свободный буфер, пока EasyDMA передаёт предыдущий.
+ * Если передача идёт, кадр запускается по её окончании; ещё не начатый
+ * кадр из очереди заменяется новым.
+ *
+ * @param p_pixels Пиксели, pixel_count штук
+ */
+void ws2812_show(ws2812_pixel_t const * p_pixels);
+
+/**
+ * @brief Останавливает передачу и отключает пин данных
+ *
+ * Лента держит последний принятый кадр - чтобы погасить её, перед вызовом
+ * нужно передать чёрный кадр и дождаться окончания передачи.
+ */
+void ws2812_uninit(void);
+
+/**
+ * @brief Идёт передача кадра
+ */
+bool ws2812_is_busy(void);
+
+/**
+ * @brief Время кодирования последнего кадра, мкс
+ */
+uint32_t ws2812_encode_time_us(void);
+
+/**
+ * @brief Максимальная частота кадров для ленты заданной длины
+ *
+ * Ограничена временем передачи: 8 бит на канал по WS2812_BIT_NS плюс
+ * пауза сброса. Кодирование идёт параллельно передаче и не учитывается,
+ * пока оно короче передачи.
+ *
+ * | пикселей | GRB, кадр/с | GRBW, кадр/с |
+ * |---------:|------------:|-------------:|
+ * |       60 |         476 |          370 |
+ * |      144 |         216 |          165 |
+ * |      300 |         107 |           81 |
+ * |      500 |          65 |           49 |
+ * |     1000 |          33 |           24 |
+ *
+ * Основной таймер обновляет ленту раз в 20 мс (50 кадр/с): этого хватает
+ * примерно до 800 пикселей GRB.
+ *
+ * @param type Тип ленты
+ * @param pixel_count Количество пикселей
+ * @return Кадров в секунду
+ */
+uint32_t ws2812_max_fps(ws2812_type_t type, uint16_t pixel_count);
+
+#endif // WS2812_H__